@@ -3,6 +3,11 @@ const { command, summary, flag } = require('paparam')
 const { configure, test } = require('brittle')
 const writeBenchmark = require('./write')
 const readBenchmark = require('./read')
+const workloadsBenchmark = require('./workloads')
+const sweepBenchmark = require('./sweep')
+const scaleBenchmark = require('./scale')
+const replayBenchmark = require('./replay')
+const report = require('./report')
 const RocksDB = require('..')
 const { BloomFilterPolicy, RibbonFilterPolicy } = RocksDB
 
@@ -12,6 +17,29 @@ const cmd = command(
 
   // Benchmark options
   flag('--duration|-d <value>', 'Maximum execution time per step in seconds, defaults to 15'),
+  flag('--json <path>', 'Write the results of every step as JSON'),
+  flag('--baseline <path>', 'Fail on regressions against the results of an earlier --json run'),
+  flag(
+    '--threshold <value>',
+    'Relative regression tolerated against the baseline, defaults to 0.1'
+  ),
+
+  // Workload options
+  flag(
+    '--workloads|-w <list>',
+    'Comma separated list of fillseq, fillrandom, overwrite, readrandom, readseq, seekrandom, readwhilewriting, deleterandom and mixed'
+  ),
+  flag('--keySize <value>', 'Defaults to 16'),
+  flag('--valueSize <value>', 'Defaults to 100'),
+  flag('--batchSize <value>', 'Operations per batch, defaults to 1'),
+  flag('--keys <value>', 'Key space of fillrandom, defaults to 1000000'),
+  flag('--readRatios <list>', 'Comma separated read ratios of mixed, defaults to 0.5,0.95'),
+  flag('--sweep <list>', 'Sweep the capacity of batch, iterator or both instead of workloads'),
+  flag('--scale <list>', 'Comma separated instance counts to open and drive concurrently'),
+  flag('--scaleColumnFamilies', 'Scale column families of a single instance rather than instances'),
+  flag('--replay <path>', 'Replay a trace captured with db.startTrace() against a fresh database'),
+  flag('--speedup <value>', 'Replay speedup relative to the captured timing, defaults to 1'),
+  flag('--concurrency <value>', 'Replay threads, defaults to 1'),
 
   // RocksDB state options
   flag('--maxBackgroundJobs <value>', 'Defaults to 6'),
@@ -54,6 +82,22 @@ const cmd = command(
 
     if (cmd.flags.duration) benchOpts.duration = Number(cmd.flags.duration * 1000)
 
+    // Report options
+    const reportOpts = {
+      json: cmd.flags.json || null,
+      baseline: cmd.flags.baseline || null,
+      threshold: cmd.flags.threshold ? Number(cmd.flags.threshold) : 0.1
+    }
+
+    // Workload options
+    const workloadOpts = {}
+
+    if (cmd.flags.keySize) workloadOpts.keySize = Number(cmd.flags.keySize)
+    if (cmd.flags.valueSize) workloadOpts.valueSize = Number(cmd.flags.valueSize)
+    if (cmd.flags.batchSize) workloadOpts.batchSize = Number(cmd.flags.batchSize)
+    if (cmd.flags.keys) workloadOpts.keys = Number(cmd.flags.keys)
+    if (cmd.flags.readRatios) workloadOpts.readRatios = cmd.flags.readRatios.split(',').map(Number)
+
     // RocksDB options
     const dbOpts = {}
 
@@ -110,11 +154,42 @@ const cmd = command(
     if (cmd.flags.asyncIO) readOpts.asyncIO = true
     if (cmd.flags.noFillCache) readOpts.fillCache = false
 
-    startBenchmark(benchOpts, dbOpts, readOpts)
+    workloadOpts.readOpts = readOpts
+
+    const workloads = cmd.flags.workloads ? cmd.flags.workloads.split(',') : null
+    const sweep = cmd.flags.sweep ? cmd.flags.sweep.split(',') : null
+
+    if (cmd.flags.replay) {
+      const replayOpts = {
+        speedup: cmd.flags.speedup ? Number(cmd.flags.speedup) : 1,
+        concurrency: cmd.flags.concurrency ? Number(cmd.flags.concurrency) : 1
+      }
+
+      startReplayBenchmark(cmd.flags.replay, dbOpts, replayOpts, reportOpts)
+      return
+    }
+
+    if (cmd.flags.scale) {
+      const counts = cmd.flags.scale.split(',').map(Number)
+      const mode = cmd.flags.scaleColumnFamilies ? 'columnFamilies' : 'instances'
+
+      startScaleBenchmark(benchOpts, dbOpts, counts, mode, reportOpts)
+      return
+    }
+
+    startBenchmark(benchOpts, dbOpts, readOpts, workloads, sweep, workloadOpts, reportOpts)
   }
 )
 
-async function startBenchmark(benchOpts, dbOpts, readOpts) {
+async function startBenchmark(
+  benchOpts,
+  dbOpts,
+  readOpts,
+  workloads,
+  sweep,
+  workloadOpts,
+  reportOpts
+) {
   configure({ timeout: 600_000 })
 
   test('Benchmark', async (t) => {
@@ -122,10 +197,50 @@ async function startBenchmark(benchOpts, dbOpts, readOpts) {
     await db.ready()
     t.teardown(() => db.close())
 
-    const keysAmount = await writeBenchmark(t, db, benchOpts)
+    if (sweep !== null) {
+      await sweepBenchmark(t, db, sweep, benchOpts, workloadOpts)
+    } else if (workloads !== null) {
+      await workloadsBenchmark(t, db, workloads, benchOpts, workloadOpts)
+    } else {
+      const keysAmount = await writeBenchmark(t, db, benchOpts)
+
+      await readBenchmark(t, db, keysAmount, benchOpts, readOpts)
+    }
+
+    finish(t, reportOpts)
+  })
+}
+
+async function startScaleBenchmark(benchOpts, dbOpts, counts, mode, reportOpts) {
+  configure({ timeout: 3_600_000 })
+
+  test('Scaling', async (t) => {
+    await scaleBenchmark(t, counts, benchOpts, { mode, dbOpts })
 
-    readBenchmark(t, db, keysAmount, benchOpts, readOpts)
+    finish(t, reportOpts)
   })
 }
 
+async function startReplayBenchmark(trace, dbOpts, replayOpts, reportOpts) {
+  configure({ timeout: 3_600_000 })
+
+  test('Replay', async (t) => {
+    await replayBenchmark(t, trace, dbOpts, replayOpts)
+
+    finish(t, reportOpts)
+  })
+}
+
+function finish(t, reportOpts) {
+  if (reportOpts.json) report.write(reportOpts.json)
+
+  if (reportOpts.baseline) {
+    const regressions = report.compare(reportOpts.baseline, reportOpts.threshold)
+
+    for (const regression of regressions) t.comment('Regression:', regression)
+
+    t.is(regressions.length, 0, 'no regressions against baseline')
+  }
+}
+
 cmd.parse()
@@ -1,3 +1,5 @@
+const Histogram = require('./histogram')
+
 const minimumSamplingTime = 500
 const minimumSamplingCount = 30
 
@@ -31,17 +33,28 @@ module.exports = async function bench(fn, opts = {}) {
 
   /**
    * Step 2: Collect samples for up to the maximum sampling time or until the
-   * confidence interval is within the desired precision relative to the mean.
+   * confidence interval is within the desired precision relative to the mean,
+   * recording the latency of every call in microseconds.
    */
 
   const samples = []
+  const latency = new Histogram()
+  const usage = resources()
 
   while (elapsed < maximumSamplingTime) {
-    const start = now()
+    let sample = 0
 
-    for (let i = 0; i < iterations; i++) await fn()
+    for (let i = 0; i < iterations; i++) {
+      const start = now()
 
-    const sample = now() - start
+      await fn()
+
+      const time = now() - start
+
+      latency.record(time * 1e3)
+
+      sample += time
+    }
 
     const period = sample / iterations
 
@@ -57,7 +70,66 @@ module.exports = async function bench(fn, opts = {}) {
     }
   }
 
-  return mean(samples) | 0
+  return {
+    ops: mean(samples) | 0,
+    latency: latency.toJSON(),
+    ...resources(usage)
+  }
+}
+
+/**
+ * CPU time in milliseconds, resident set size in bytes and garbage collection
+ * count since the given snapshot, where the runtime exposes them.
+ */
+
+let gc = null
+
+try {
+  const { PerformanceObserver } = require('perf_hooks')
+
+  gc = { count: 0, duration: 0 }
+
+  new PerformanceObserver((list) => {
+    for (const entry of list.getEntries()) {
+      gc.count++
+      gc.duration += entry.duration
+    }
+  }).observe({ entryTypes: ['gc'] })
+} catch {
+  gc = null
+}
+
+function resources(since = null) {
+  const usage = {
+    cpu: null,
+    rss: null,
+    gc: gc === null ? null : { ...gc }
+  }
+
+  if (typeof process === 'object') {
+    if (typeof process.cpuUsage === 'function') {
+      const { user, system } = process.cpuUsage()
+      usage.cpu = { user: user / 1e3, system: system / 1e3 }
+    }
+
+    if (typeof process.memoryUsage === 'function') usage.rss = process.memoryUsage().rss
+  }
+
+  if (since === null) return usage
+
+  if (usage.cpu !== null) {
+    usage.cpu.user -= since.cpu.user
+    usage.cpu.system -= since.cpu.system
+  }
+
+  if (usage.rss !== null) usage.rss -= since.rss
+
+  if (usage.gc !== null) {
+    usage.gc.count -= since.gc.count
+    usage.gc.duration -= since.gc.duration
+  }
+
+  return usage
 }
 
 let now
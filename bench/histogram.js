@@ -0,0 +1,82 @@
+// Log-linear histogram in the style of HDR histograms, using the same buckets
+// and percentile rule as the one the binding uses for its latency diagnostics:
+// every power of two is split into 8 linear sub-buckets, which bounds the
+// relative error of a recorded value to 12.5%, and values from 2^37 up share
+// the last bucket.
+
+const SUB_BITS = 3
+const SUB_BUCKETS = 1 << SUB_BITS
+const MAX_BITS = 36
+const BUCKETS = (MAX_BITS - SUB_BITS + 2) << SUB_BITS
+
+module.exports = class Histogram {
+  constructor() {
+    this.count = 0
+    this.sum = 0
+    this.min = 0
+    this.max = 0
+    this.buckets = new Uint32Array(BUCKETS)
+  }
+
+  record(value) {
+    value = Math.max(0, Math.round(value))
+
+    if (this.count === 0 || value < this.min) this.min = value
+    if (value > this.max) this.max = value
+
+    this.count++
+    this.sum += value
+    this.buckets[index(value)]++
+  }
+
+  percentile(p) {
+    if (this.count === 0) return 0
+
+    const rank = Math.max(Math.floor((p / 100) * this.count), 1)
+
+    let seen = 0
+
+    for (let i = 0; i < BUCKETS; i++) {
+      seen += this.buckets[i]
+
+      if (seen >= rank) return Math.min(value(i), this.max)
+    }
+
+    return this.max
+  }
+
+  toJSON() {
+    return {
+      count: this.count,
+      min: this.min,
+      max: this.max,
+      mean: this.count === 0 ? 0 : this.sum / this.count,
+      p50: this.percentile(50),
+      p90: this.percentile(90),
+      p99: this.percentile(99),
+      p999: this.percentile(99.9)
+    }
+  }
+}
+
+function index(value) {
+  if (value < SUB_BUCKETS) return value
+
+  const msb = Math.floor(Math.log2(value))
+
+  if (msb > MAX_BITS) return BUCKETS - 1
+
+  const shift = msb - SUB_BITS
+
+  return (shift + 1) * SUB_BUCKETS + Math.floor(value / 2 ** shift) - SUB_BUCKETS
+}
+
+// Highest value that maps to the bucket, as reported by HDR histograms
+function value(index) {
+  if (index < SUB_BUCKETS) return index
+
+  const shift = Math.floor(index / SUB_BUCKETS) - 1
+  const mantissa = (index % SUB_BUCKETS) + SUB_BUCKETS
+
+  return (mantissa + 1) * 2 ** shift - 1
+}
@@ -0,0 +1,501 @@
+#include <assert.h>
+#include <math.h>
+#include <rocksdb.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <uv.h>
+
+#include <string>
+#include <vector>
+
+// Drives librocksdb directly from a libuv loop, with the same workloads, key
+// format and defaults as bench/workloads.js, so that comparing the two reports
+// isolates the cost of marshalling requests through the binding.
+
+#define ROCKSDB_NATIVE_BENCH_SUB_BITS 3
+#define ROCKSDB_NATIVE_BENCH_BUCKETS  ((40 - ROCKSDB_NATIVE_BENCH_SUB_BITS + 2) << ROCKSDB_NATIVE_BENCH_SUB_BITS)
+
+struct rocksdb_native_bench_histogram_t {
+  uint64_t count;
+  uint64_t sum;
+  uint64_t min;
+  uint64_t max;
+  uint64_t buckets[ROCKSDB_NATIVE_BENCH_BUCKETS];
+};
+
+enum rocksdb_native_bench_workload_t {
+  rocksdb_native_bench_fillseq,
+  rocksdb_native_bench_readrandom,
+  rocksdb_native_bench_readseq,
+};
+
+struct rocksdb_native_bench_t {
+  rocksdb_t db;
+
+  uv_loop_t *loop;
+
+  rocksdb_options_t options;
+  rocksdb_column_family_descriptor_t descriptor;
+  rocksdb_column_family_t *column_family;
+
+  rocksdb_open_t open;
+  rocksdb_close_t close;
+
+  rocksdb_write_batch_t write;
+  rocksdb_read_batch_t read;
+  rocksdb_iterator_t iterator;
+
+  std::vector<rocksdb_write_t> writes;
+  std::vector<rocksdb_read_t> reads;
+  std::vector<rocksdb_slice_t> keys;
+  std::vector<rocksdb_slice_t> values;
+  std::vector<std::string> key_storage;
+  std::string value;
+
+  const char *path;
+  double duration;
+  size_t key_size;
+  size_t value_size;
+  size_t batch_size;
+
+  rocksdb_native_bench_workload_t workload;
+  uint64_t deadline;
+  uint64_t started;
+  uint64_t submitted;
+  uint64_t operations;
+  uint64_t written;
+  bool end;
+
+  rocksdb_native_bench_histogram_t latency;
+};
+
+static size_t
+rocksdb_native_bench__histogram_index(uint64_t value) {
+  if (value < (2 << ROCKSDB_NATIVE_BENCH_SUB_BITS)) return value;
+
+  int bits = 63 - __builtin_clzll(value);
+  int shift = bits - ROCKSDB_NATIVE_BENCH_SUB_BITS;
+
+  size_t index = (size_t(shift) << ROCKSDB_NATIVE_BENCH_SUB_BITS) + (value >> shift);
+
+  return index < ROCKSDB_NATIVE_BENCH_BUCKETS ? index : ROCKSDB_NATIVE_BENCH_BUCKETS - 1;
+}
+
+static uint64_t
+rocksdb_native_bench__histogram_value(size_t index) {
+  if (index < (2 << ROCKSDB_NATIVE_BENCH_SUB_BITS)) return index;
+
+  int shift = int(index >> ROCKSDB_NATIVE_BENCH_SUB_BITS) - 1;
+  uint64_t mantissa = (index & ((1 << ROCKSDB_NATIVE_BENCH_SUB_BITS) - 1)) + (1 << ROCKSDB_NATIVE_BENCH_SUB_BITS);
+
+  return ((mantissa + 1) << shift) - 1;
+}
+
+static void
+rocksdb_native_bench__histogram_record(rocksdb_native_bench_histogram_t *histogram, uint64_t value) {
+  if (histogram->count == 0 || value < histogram->min) histogram->min = value;
+  if (value > histogram->max) histogram->max = value;
+
+  histogram->count++;
+  histogram->sum += value;
+  histogram->buckets[rocksdb_native_bench__histogram_index(value)]++;
+}
+
+static uint64_t
+rocksdb_native_bench__histogram_percentile(rocksdb_native_bench_histogram_t *histogram, double p) {
+  if (histogram->count == 0) return 0;
+
+  uint64_t rank = uint64_t(ceil(p / 100 * double(histogram->count)));
+  uint64_t seen = 0;
+
+  for (size_t i = 0; i < ROCKSDB_NATIVE_BENCH_BUCKETS; i++) {
+    seen += histogram->buckets[i];
+
+    if (seen >= rank) {
+      uint64_t value = rocksdb_native_bench__histogram_value(i);
+
+      if (value < histogram->min) return histogram->min;
+      if (value > histogram->max) return histogram->max;
+
+      return value;
+    }
+  }
+
+  return histogram->max;
+}
+
+static void
+rocksdb_native_bench__key(rocksdb_native_bench_t *bench, size_t i, uint64_t n) {
+  auto &key = bench->key_storage[i];
+
+  snprintf(key.data(), key.size() + 1, "%0*llu", int(bench->key_size), (unsigned long long) n);
+
+  bench->keys[i] = {key.data(), key.size()};
+}
+
+static uint64_t
+rocksdb_native_bench__random(uint64_t max) {
+  return max == 0 ? 0 : uint64_t(drand48() * double(max));
+}
+
+static void
+rocksdb_native_bench__next(rocksdb_native_bench_t *bench);
+
+static void
+rocksdb_native_bench__on_write(rocksdb_write_batch_t *handle, int status) {
+  assert(status == 0);
+
+  auto bench = reinterpret_cast<rocksdb_native_bench_t *>(handle->data);
+
+  if (handle->error) {
+    fprintf(stderr, "write failed: %s\n", handle->error);
+    exit(1);
+  }
+
+  bench->written += bench->batch_size;
+
+  rocksdb_native_bench__next(bench);
+}
+
+static void
+rocksdb_native_bench__on_read(rocksdb_read_batch_t *handle, int status) {
+  assert(status == 0);
+
+  auto bench = reinterpret_cast<rocksdb_native_bench_t *>(handle->data);
+
+  for (size_t i = 0; i < handle->len; i++) {
+    if (handle->errors[i]) {
+      fprintf(stderr, "read failed: %s\n", handle->errors[i]);
+      exit(1);
+    }
+
+    auto value = &bench->reads[i].value;
+
+    if (value->data) rocksdb_slice_destroy(value);
+  }
+
+  rocksdb_native_bench__next(bench);
+}
+
+static void
+rocksdb_native_bench__on_iterator_read(rocksdb_iterator_t *handle, int status) {
+  assert(status == 0);
+
+  auto bench = reinterpret_cast<rocksdb_native_bench_t *>(handle->data);
+
+  if (handle->error) {
+    fprintf(stderr, "iterator read failed: %s\n", handle->error);
+    exit(1);
+  }
+
+  for (size_t i = 0; i < handle->len; i++) {
+    rocksdb_slice_destroy(&bench->keys[i]);
+    rocksdb_slice_destroy(&bench->values[i]);
+  }
+
+  // Start over from the first key once the end is reached, like the readseq
+  // workload of the JavaScript suite.
+  bench->end = handle->len < bench->batch_size;
+
+  rocksdb_native_bench__next(bench);
+}
+
+static void
+rocksdb_native_bench__on_iterator_open(rocksdb_iterator_t *handle, int status) {
+  int err;
+
+  assert(status == 0);
+
+  auto bench = reinterpret_cast<rocksdb_native_bench_t *>(handle->data);
+
+  if (handle->error) {
+    fprintf(stderr, "iterator open failed: %s\n", handle->error);
+    exit(1);
+  }
+
+  err = rocksdb_iterator_read(&bench->iterator, bench->keys.data(), bench->values.data(), bench->batch_size, rocksdb_native_bench__on_iterator_read);
+  assert(err == 0);
+}
+
+static void
+rocksdb_native_bench__open_iterator(rocksdb_native_bench_t *bench) {
+  int err;
+
+  rocksdb_range_t range;
+  memset(&range, 0, sizeof(range));
+
+  rocksdb_iterator_options_t options = {
+    .version = 2,
+  };
+
+  bench->end = false;
+
+  err = rocksdb_iterator_open(&bench->db, &bench->iterator, bench->column_family, range, &options, rocksdb_native_bench__on_iterator_open);
+  assert(err == 0);
+}
+
+static void
+rocksdb_native_bench__on_iterator_reopen(rocksdb_iterator_t *handle, int status) {
+  assert(status == 0);
+
+  auto bench = reinterpret_cast<rocksdb_native_bench_t *>(handle->data);
+
+  rocksdb_iterator_cleanup(&bench->iterator);
+
+  rocksdb_native_bench__open_iterator(bench);
+}
+
+static void
+rocksdb_native_bench__submit(rocksdb_native_bench_t *bench) {
+  int err;
+
+  bench->submitted = uv_hrtime();
+
+  switch (bench->workload) {
+  case rocksdb_native_bench_fillseq: {
+    for (size_t i = 0; i < bench->batch_size; i++) {
+      rocksdb_native_bench__key(bench, i, bench->written + i);
+
+      bench->writes[i].type = rocksdb_put;
+      bench->writes[i].column_family = bench->column_family;
+      bench->writes[i].key = bench->keys[i];
+      bench->writes[i].value = {bench->value.data(), bench->value.size()};
+    }
+
+    rocksdb_write_options_t options = {
+      .version = 2,
+    };
+
+    err = rocksdb_write(&bench->db, &bench->write, bench->writes.data(), bench->batch_size, &options, rocksdb_native_bench__on_write);
+    assert(err == 0);
+    break;
+  }
+
+  case rocksdb_native_bench_readrandom: {
+    for (size_t i = 0; i < bench->batch_size; i++) {
+      rocksdb_native_bench__key(bench, i, rocksdb_native_bench__random(bench->written));
+
+      bench->reads[i].type = rocksdb_get;
+      bench->reads[i].column_family = bench->column_family;
+      bench->reads[i].key = bench->keys[i];
+    }
+
+    rocksdb_read_options_t options = {
+      .version = 4,
+      .fill_cache = true,
+    };
+
+    err = rocksdb_read(&bench->db, &bench->read, bench->reads.data(), bench->batch_size, &options, rocksdb_native_bench__on_read);
+    assert(err == 0);
+    break;
+  }
+
+  case rocksdb_native_bench_readseq: {
+    if (bench->end) {
+      err = rocksdb_iterator_close(&bench->iterator, rocksdb_native_bench__on_iterator_reopen);
+      assert(err == 0);
+    } else {
+      err = rocksdb_iterator_read(&bench->iterator, bench->keys.data(), bench->values.data(), bench->batch_size, rocksdb_native_bench__on_iterator_read);
+      assert(err == 0);
+    }
+    break;
+  }
+  }
+}
+
+static void
+rocksdb_native_bench__report(rocksdb_native_bench_t *bench, const char *name) {
+  auto histogram = &bench->latency;
+
+  double elapsed = double(uv_hrtime() - bench->started) / 1e9;
+
+  uint64_t ops = uint64_t(double(bench->operations) / elapsed);
+
+  printf(
+    "  \"%s\": { \"ops\": %llu, \"batchSize\": %zu, \"latency\": { \"count\": %llu, \"min\": %llu, \"max\": %llu, \"mean\": %.3f, \"p50\": %llu, \"p90\": %llu, \"p99\": %llu, \"p999\": %llu } }",
+    name,
+    (unsigned long long) ops,
+    bench->batch_size,
+    (unsigned long long) histogram->count,
+    (unsigned long long) histogram->min,
+    (unsigned long long) histogram->max,
+    histogram->count == 0 ? 0.0 : double(histogram->sum) / double(histogram->count),
+    (unsigned long long) rocksdb_native_bench__histogram_percentile(histogram, 50),
+    (unsigned long long) rocksdb_native_bench__histogram_percentile(histogram, 90),
+    (unsigned long long) rocksdb_native_bench__histogram_percentile(histogram, 99),
+    (unsigned long long) rocksdb_native_bench__histogram_percentile(histogram, 99.9)
+  );
+}
+
+static void
+rocksdb_native_bench__start(rocksdb_native_bench_t *bench, rocksdb_native_bench_workload_t workload);
+
+static void
+rocksdb_native_bench__on_close(rocksdb_close_t *handle, int status) {
+  assert(status == 0);
+
+  rocksdb_close_cleanup(handle);
+}
+
+static void
+rocksdb_native_bench__on_idle(rocksdb_t *handle) {
+  int err;
+
+  auto bench = reinterpret_cast<rocksdb_native_bench_t *>(handle);
+
+  err = rocksdb_column_family_destroy(&bench->db, bench->column_family);
+  assert(err == 0);
+}
+
+static void
+rocksdb_native_bench__on_iterator_close(rocksdb_iterator_t *handle, int status) {
+  int err;
+
+  assert(status == 0);
+
+  auto bench = reinterpret_cast<rocksdb_native_bench_t *>(handle->data);
+
+  rocksdb_iterator_cleanup(&bench->iterator);
+
+  err = rocksdb_close(&bench->db, &bench->close, rocksdb_native_bench__on_idle, rocksdb_native_bench__on_close);
+  assert(err == 0);
+}
+
+static void
+rocksdb_native_bench__next(rocksdb_native_bench_t *bench) {
+  int err;
+
+  uint64_t now = uv_hrtime();
+
+  rocksdb_native_bench__histogram_record(&bench->latency, (now - bench->submitted) / 1000);
+
+  bench->operations += bench->batch_size;
+
+  if (now < bench->deadline) return rocksdb_native_bench__submit(bench);
+
+  switch (bench->workload) {
+  case rocksdb_native_bench_fillseq:
+    rocksdb_native_bench__report(bench, "fillseq");
+    printf(",\n");
+    rocksdb_native_bench__start(bench, rocksdb_native_bench_readrandom);
+    break;
+
+  case rocksdb_native_bench_readrandom:
+    rocksdb_native_bench__report(bench, "readrandom");
+    printf(",\n");
+    rocksdb_native_bench__start(bench, rocksdb_native_bench_readseq);
+    break;
+
+  case rocksdb_native_bench_readseq:
+    rocksdb_native_bench__report(bench, "readseq");
+    printf("\n}\n");
+
+    err = rocksdb_iterator_close(&bench->iterator, rocksdb_native_bench__on_iterator_close);
+    assert(err == 0);
+    break;
+  }
+}
+
+static void
+rocksdb_native_bench__start(rocksdb_native_bench_t *bench, rocksdb_native_bench_workload_t workload) {
+  bench->workload = workload;
+  bench->operations = 0;
+  bench->started = uv_hrtime();
+  bench->deadline = bench->started + uint64_t(bench->duration * 1e9);
+
+  memset(&bench->latency, 0, sizeof(bench->latency));
+
+  if (workload == rocksdb_native_bench_readseq) {
+    // The iterator reads `batch_size` entries at a time, so its steps line up
+    // with the readseq workload of the JavaScript suite.
+    bench->submitted = uv_hrtime();
+
+    rocksdb_native_bench__open_iterator(bench);
+  } else {
+    rocksdb_native_bench__submit(bench);
+  }
+}
+
+static void
+rocksdb_native_bench__on_open(rocksdb_open_t *handle, int status) {
+  assert(status == 0);
+
+  auto bench = reinterpret_cast<rocksdb_native_bench_t *>(handle->data);
+
+  if (handle->error) {
+    fprintf(stderr, "open failed: %s\n", handle->error);
+    exit(1);
+  }
+
+  rocksdb_open_cleanup(handle);
+
+  printf("{\n");
+
+  rocksdb_native_bench__start(bench, rocksdb_native_bench_fillseq);
+}
+
+static const char *
+rocksdb_native_bench__flag(int argc, char **argv, const char *name, const char *fallback) {
+  for (int i = 1; i < argc - 1; i++) {
+    if (strcmp(argv[i], name) == 0) return argv[i + 1];
+  }
+
+  return fallback;
+}
+
+int
+main(int argc, char **argv) {
+  int err;
+
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <path> [--duration <seconds>] [--keySize <bytes>] [--valueSize <bytes>] [--batchSize <ops>]\n", argv[0]);
+    return 1;
+  }
+
+  auto bench = new rocksdb_native_bench_t();
+
+  bench->loop = uv_default_loop();
+  bench->path = argv[1];
+  bench->duration = atof(rocksdb_native_bench__flag(argc, argv, "--duration", "15"));
+  bench->key_size = size_t(atoi(rocksdb_native_bench__flag(argc, argv, "--keySize", "16")));
+  bench->value_size = size_t(atoi(rocksdb_native_bench__flag(argc, argv, "--valueSize", "100")));
+  bench->batch_size = size_t(atoi(rocksdb_native_bench__flag(argc, argv, "--batchSize", "1")));
+
+  bench->writes.resize(bench->batch_size);
+  bench->reads.resize(bench->batch_size);
+  bench->keys.resize(bench->batch_size);
+  bench->values.resize(bench->batch_size);
+  bench->key_storage.assign(bench->batch_size, std::string(bench->key_size, '0'));
+  bench->value.resize(bench->value_size);
+
+  for (auto &c : bench->value) c = char(rand());
+
+  bench->open.data = bench;
+  bench->close.data = bench;
+  bench->write.data = bench;
+  bench->read.data = bench;
+  bench->iterator.data = bench;
+
+  rocksdb_options_init(&bench->options, 11);
+
+  bench->options.create_if_missing = true;
+
+  bench->descriptor.name = "default";
+
+  rocksdb_column_family_options_init(&bench->descriptor.options, 11);
+
+  err = rocksdb_open(bench->loop, &bench->db, &bench->open, bench->path, &bench->options, &bench->descriptor, &bench->column_family, 1, nullptr, rocksdb_native_bench__on_open);
+
+  if (err < 0) {
+    fprintf(stderr, "open failed: %s\n", uv_strerror(err));
+    return 1;
+  }
+
+  err = uv_run(bench->loop, UV_RUN_DEFAULT);
+  assert(err == 0);
+
+  delete bench;
+
+  return 0;
+}
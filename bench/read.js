@@ -1,7 +1,8 @@
 const bench = require('./harness')
+const report = require('./report')
 
 module.exports = function readBenchmark(t, db, keysLimit, benchOpts, opts) {
-  t.test('Reading', async (t) => {
+  return t.test('Reading', async (t) => {
     t.plan(1)
 
     let keysRead = 0
@@ -17,7 +18,7 @@ module.exports = function readBenchmark(t, db, keysLimit, benchOpts, opts) {
       keysRead++
     }, benchOpts)
 
-    t.comment('Reading performance:', result, 'ops/s')
+    report.record(t, 'Reading', result)
     t.comment('Keys read:', keysRead)
     t.pass()
   })
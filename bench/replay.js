@@ -0,0 +1,39 @@
+const path = require('path')
+const report = require('./report')
+const RocksDB = require('..')
+
+// Replays a trace captured with db.startTrace() against a fresh database, so
+// production access patterns can be reproduced offline with different cache
+// and compaction settings.
+
+module.exports = async function replayBenchmark(t, trace, dbOpts, opts = {}) {
+  const { speedup = 1, concurrency = 1 } = opts
+
+  const test = t.test('Replay')
+  test.plan(1)
+
+  const db = new RocksDB(path.join(await t.tmp(), 'replay'), dbOpts)
+  await db.ready()
+
+  const start = Date.now()
+  const latency = await db.replayTrace(trace, { speedup, concurrency })
+  const elapsed = (Date.now() - start) / 1000
+
+  for (const [name, histogram] of Object.entries(latency)) {
+    if (histogram.count === 0) continue
+
+    report.record(test, `replay ${name}`, {
+      ops: (histogram.count / elapsed) | 0,
+      latency: histogram,
+      cpu: null,
+      rss: null,
+      gc: null
+    })
+  }
+
+  test.comment('Replay time (s):', elapsed)
+
+  await db.close()
+
+  test.pass()
+}
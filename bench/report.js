@@ -0,0 +1,61 @@
+const fs = require('fs')
+
+// Results of every step, keyed by step name, in the shape written by `--json`
+// and read back by `--baseline`.
+const results = {}
+
+exports.results = results
+
+exports.record = function record(t, name, result, opts = {}) {
+  const { batchSize = 1 } = opts
+
+  results[name] = { ...result, ops: result.ops * batchSize, batchSize }
+
+  const { latency, cpu, rss, gc } = result
+
+  t.comment(name, 'performance:', result.ops * batchSize, 'ops/s')
+  t.comment(
+    'Latency per call (us):',
+    `p50=${latency.p50} p90=${latency.p90} p99=${latency.p99} p99.9=${latency.p999} max=${latency.max}`
+  )
+
+  if (batchSize > 1) {
+    const p50 = (latency.p50 / batchSize).toFixed(3)
+    const p99 = (latency.p99 / batchSize).toFixed(3)
+
+    t.comment('Latency per operation (us):', `p50=${p50} p99=${p99}`)
+  }
+
+  if (cpu !== null) t.comment('CPU time (ms):', `user=${cpu.user | 0} system=${cpu.system | 0}`)
+  if (rss !== null) t.comment('RSS change (MiB):', (rss / 1048576).toFixed(1))
+  if (gc !== null) t.comment('GC:', gc.count, 'collections,', gc.duration.toFixed(1), 'ms')
+}
+
+exports.write = function write(path) {
+  fs.writeFileSync(path, JSON.stringify(results, null, 2) + '\n')
+}
+
+// Compares throughput and tail latency of every step present in both runs,
+// returning a description of each that regressed by more than the threshold.
+exports.compare = function compare(path, threshold = 0.1) {
+  const baseline = JSON.parse(fs.readFileSync(path, 'utf8'))
+
+  const regressions = []
+
+  for (const [name, result] of Object.entries(results)) {
+    const base = baseline[name]
+    if (!base) continue
+
+    if (result.ops < base.ops * (1 - threshold)) {
+      regressions.push(`${name}: ${result.ops} ops/s, baseline ${base.ops} ops/s`)
+    }
+
+    for (const p of ['p99', 'p999']) {
+      if (result.latency[p] > base.latency[p] * (1 + threshold)) {
+        regressions.push(`${name}: ${p} ${result.latency[p]} us, baseline ${base.latency[p]} us`)
+      }
+    }
+  }
+
+  return regressions
+}
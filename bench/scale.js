@@ -0,0 +1,112 @@
+const crypto = require('crypto')
+const fs = require('fs')
+const path = require('path')
+const bench = require('./harness')
+const report = require('./report')
+const RocksDB = require('..')
+
+// Opens N instances, or N column families of a single instance, and drives a
+// concurrent read and write workload across all of them to expose the fixed
+// per-instance costs that dominate processes hosting hundreds of databases.
+
+module.exports = async function scaleBenchmark(t, counts, benchOpts, opts = {}) {
+  const { mode = 'instances', dbOpts = {}, keys = 1000, valueSize = 100 } = opts
+
+  const value = crypto.randomBytes(valueSize)
+
+  for (const n of counts) {
+    const name = `${mode}=${n}`
+
+    const test = t.test(name)
+    test.plan(1)
+
+    const dir = await t.tmp()
+
+    const fds = openFiles()
+    const rss = process.memoryUsage().rss
+    const start = Date.now()
+
+    const dbs = []
+
+    let root = null
+
+    if (mode === 'instances') {
+      for (let i = 0; i < n; i++) dbs.push(new RocksDB(path.join(dir, String(i)), dbOpts))
+
+      await Promise.all(dbs.map((db) => db.ready()))
+    } else {
+      const columnFamilies = []
+      for (let i = 0; i < n; i++) columnFamilies.push('cf' + i)
+
+      root = new RocksDB(dir, { ...dbOpts, columnFamilies })
+      await root.ready()
+
+      for (const columnFamily of columnFamilies) dbs.push(root.columnFamily(columnFamily))
+    }
+
+    const openTime = Date.now() - start
+
+    for (const db of dbs) {
+      const batch = db.write({ capacity: keys })
+      for (let i = 0; i < keys; i++) batch.tryPut(String(i), value)
+      await batch.flush()
+      batch.destroy()
+    }
+
+    const result = await bench(async () => {
+      await Promise.all(
+        dbs.map(async (db) => {
+          const key = String(Math.floor(Math.random() * keys))
+
+          const write = db.write()
+          write.tryPut(key, value)
+          await write.flush()
+          write.destroy()
+
+          const read = db.read()
+          const p = read.get(key)
+          await read.flush()
+          read.destroy()
+          await p
+        })
+      )
+    }, benchOpts)
+
+    // Instances opened as column families share their state and therefore its
+    // latency histograms, so only the first session needs sampling.
+    const sampled = mode === 'instances' ? dbs : dbs.slice(0, 1)
+
+    let queue = 0
+    let memory = 0
+
+    for (const db of sampled) {
+      const { latency } = db.diagnostics({ latency: true })
+
+      queue = Math.max(queue, latency.read.queue.p99, latency.write.queue.p99)
+    }
+
+    for (const db of sampled) memory += (await db.memoryUsage()).total
+
+    report.record(test, name, result, { batchSize: n })
+
+    test.comment('Open time (ms):', openTime)
+    test.comment('RSS per instance (KiB):', ((process.memoryUsage().rss - rss) / n / 1024) | 0)
+    test.comment('RocksDB memory per instance (KiB):', (memory / n / 1024) | 0)
+    test.comment('Thread pool queueing p99 (us):', queue)
+    if (fds !== null) test.comment('File descriptors per instance:', (openFiles() - fds) / n)
+
+    await Promise.all(dbs.map((db) => db.close()))
+
+    if (root !== null) await root.close()
+
+    test.pass()
+  }
+}
+
+function openFiles() {
+  try {
+    return fs.readdirSync('/proc/self/fd').length
+  } catch {
+    return null
+  }
+}
@@ -0,0 +1,107 @@
+const crypto = require('crypto')
+const bench = require('./harness')
+const report = require('./report')
+
+// Sweeps of the batch and iterator capacities, separating the per-call cost of
+// crossing into the binding from the per-operation cost of the work itself.
+
+const BATCH_CAPACITIES = [1, 4, 16, 64, 256, 1024, 4096]
+const ITERATOR_CAPACITIES = [1, 4, 16, 64, 256, 1024]
+
+module.exports = async function sweepBenchmark(t, db, kinds, benchOpts, opts = {}) {
+  const {
+    keys = 100_000,
+    valueSize = 100,
+    batchCapacities = BATCH_CAPACITIES,
+    iteratorCapacities = ITERATOR_CAPACITIES
+  } = opts
+
+  const value = crypto.randomBytes(valueSize)
+
+  const fill = t.test('Sweep fill')
+  fill.plan(1)
+
+  for (let i = 0; i < keys; i += 1024) {
+    const batch = db.write({ capacity: 1024 })
+    for (let j = i; j < i + 1024 && j < keys; j++) batch.tryPut(key(j), value)
+    await batch.flush()
+    batch.destroy()
+  }
+
+  fill.pass()
+
+  if (kinds.includes('batch')) {
+    for (const capacity of batchCapacities) {
+      // Small batches are pooled by the state, so compare the reuse path
+      // against allocating a fresh batch every call wherever it was taken.
+      for (const kind of ['write', 'read']) {
+        const step = kind === 'write' ? write : read
+
+        const reused = await run(t, `${kind} capacity=${capacity}`, db, capacity, benchOpts, () =>
+          step(capacity, true)
+        )
+
+        if (reused === 0) continue
+
+        await run(t, `${kind} capacity=${capacity} fresh`, db, capacity, benchOpts, () =>
+          step(capacity, false)
+        )
+      }
+    }
+  }
+
+  if (kinds.includes('iterator')) {
+    // Every iterator scans the same number of entries, so only the number of
+    // reads into the binding changes with the capacity.
+    const length = iteratorCapacities[iteratorCapacities.length - 1] * 4
+
+    for (const capacity of iteratorCapacities) {
+      await run(t, `iterator capacity=${capacity}`, db, length, benchOpts, async () => {
+        const it = db.iterator({ gte: randomKey(keys - length) }, { capacity, limit: length })
+        for await (const entry of it) {
+          if (entry.value === null) throw new Error('Missing value')
+        }
+      })
+    }
+  }
+
+  async function write(capacity, reuse) {
+    const batch = db.write({ capacity, reuse })
+    for (let i = 0; i < capacity; i++) batch.tryPut(randomKey(keys), value)
+    await batch.flush()
+    batch.destroy()
+  }
+
+  async function read(capacity, reuse) {
+    const batch = db.read({ capacity, reuse })
+    const promises = []
+    for (let i = 0; i < capacity; i++) promises.push(batch.get(randomKey(keys)))
+    await batch.flush()
+    batch.destroy()
+    await Promise.all(promises)
+  }
+}
+
+// Returns the number of batches taken from the pool during the step
+async function run(t, name, db, operations, benchOpts, fn) {
+  const test = t.test(name)
+  test.plan(1)
+
+  const reused = db.stats.reusedBatches
+
+  const result = await bench(fn, benchOpts)
+
+  report.record(test, name, result, { batchSize: operations })
+  test.comment('Reused batches:', db.stats.reusedBatches - reused)
+  test.pass()
+
+  return db.stats.reusedBatches - reused
+}
+
+function key(i) {
+  return String(i).padStart(16, '0')
+}
+
+function randomKey(max) {
+  return key(Math.floor(Math.random() * Math.max(max, 1)))
+}
@@ -0,0 +1,224 @@
+const crypto = require('crypto')
+const bench = require('./harness')
+const report = require('./report')
+
+// Workloads modelled after the db_bench benchmarks of the same name. Every
+// step performs one batch of `batchSize` operations, so the reported rate is
+// in operations rather than batches.
+
+module.exports = exports = async function workloadsBenchmark(t, db, workloads, benchOpts, opts) {
+  const ctx = new Context(db, opts)
+
+  for (const name of workloads) {
+    if (name === 'mixed') {
+      for (const ratio of ctx.readRatios) {
+        await run(t, `mixed (${ratio * 100}% reads)`, (ctx) => mixed(ctx, ratio), ctx, benchOpts)
+      }
+    } else {
+      const workload = exports[name]
+
+      if (typeof workload !== 'function') throw new Error('Unknown workload: ' + name)
+
+      await run(t, name, workload, ctx, benchOpts)
+    }
+  }
+}
+
+async function run(t, name, workload, ctx, benchOpts) {
+  const test = t.test(name)
+  test.plan(1)
+
+  ctx.backgroundOperations = 0
+
+  const step = await workload(ctx)
+
+  const operations = ctx.operations
+  const result = await bench(step, benchOpts)
+
+  if (step.teardown) await step.teardown()
+
+  report.record(test, name, result, { batchSize: step.batchSize || ctx.batchSize })
+  test.comment('Operations:', ctx.operations - operations)
+  if (ctx.backgroundOperations > 0) {
+    test.comment('Background operations:', ctx.backgroundOperations)
+  }
+  test.comment('Keys:', ctx.keys)
+  test.pass()
+}
+
+class Context {
+  constructor(db, opts = {}) {
+    const {
+      keySize = 16,
+      valueSize = 100,
+      batchSize = 1,
+      keys = 1_000_000,
+      readRatios = [0.5, 0.95],
+      readOpts = {}
+    } = opts
+
+    this.db = db
+    this.keySize = keySize
+    this.valueSize = valueSize
+    this.batchSize = batchSize
+    this.readRatios = readRatios
+    this.readOpts = readOpts
+
+    // Key space for fillrandom, whereas sequential fills only cover the keys
+    // they managed to write within the step duration.
+    this.keySpace = keys
+    this.keys = 0
+    this.operations = 0
+
+    // Operations of background load, such as the writer of readwhilewriting,
+    // which are kept out of the measured operations
+    this.backgroundOperations = 0
+
+    // Values are sliced out of a pool of random bytes so that generating them
+    // doesn't dominate the measurement.
+    this._pool = crypto.randomBytes(Math.max(valueSize * 1024, 65536))
+  }
+
+  key(i) {
+    return String(i).padStart(this.keySize, '0')
+  }
+
+  randomKey() {
+    return this.key(Math.floor(Math.random() * Math.max(this.keys, 1)))
+  }
+
+  value() {
+    const offset = Math.floor(Math.random() * (this._pool.byteLength - this.valueSize))
+    return this._pool.subarray(offset, offset + this.valueSize)
+  }
+
+  async write(key) {
+    await this.put(key)
+
+    this.operations += this.batchSize
+  }
+
+  async put(key) {
+    const batch = this.db.write()
+    for (let i = 0; i < this.batchSize; i++) batch.tryPut(key(), this.value())
+    await batch.flush()
+    batch.destroy()
+  }
+
+  async read() {
+    const batch = this.db.read(this.readOpts)
+    const promises = []
+    for (let i = 0; i < this.batchSize; i++) promises.push(batch.get(this.randomKey()))
+    await batch.flush()
+    batch.destroy()
+    await Promise.all(promises)
+
+    this.operations += this.batchSize
+  }
+}
+
+exports.fillseq = function fillseq(ctx) {
+  return () => ctx.write(() => ctx.key(ctx.keys++))
+}
+
+exports.fillrandom = function fillrandom(ctx) {
+  const step = () => ctx.write(() => ctx.key(Math.floor(Math.random() * ctx.keySpace)))
+
+  // Later workloads sample the whole key space, so reads may miss keys that
+  // weren't drawn, as with db_bench.
+  step.teardown = () => {
+    ctx.keys = Math.max(ctx.keys, ctx.keySpace)
+  }
+
+  return step
+}
+
+exports.overwrite = function overwrite(ctx) {
+  return () => ctx.write(() => ctx.randomKey())
+}
+
+exports.readrandom = function readrandom(ctx) {
+  return () => ctx.read()
+}
+
+exports.readseq = function readseq(ctx) {
+  let entries = null
+
+  const step = async () => {
+    for (let i = 0; i < ctx.batchSize; i++) {
+      if (entries === null) entries = ctx.db.iterator({}, ctx.readOpts)[Symbol.asyncIterator]()
+
+      const { done } = await entries.next()
+
+      if (done) entries = null
+    }
+
+    ctx.operations += ctx.batchSize
+  }
+
+  step.teardown = async () => {
+    if (entries !== null) await entries.return()
+  }
+
+  return step
+}
+
+// Like db_bench, every seek counts as one operation however many entries it
+// then reads, which here is up to `batchSize`.
+exports.seekrandom = function seekrandom(ctx) {
+  const step = async () => {
+    const it = ctx.db.iterator(
+      { gte: ctx.randomKey() },
+      { ...ctx.readOpts, limit: ctx.batchSize }
+    )
+
+    for await (const entry of it) void entry
+
+    ctx.operations++
+  }
+
+  step.batchSize = 1
+
+  return step
+}
+
+exports.readwhilewriting = function readwhilewriting(ctx) {
+  let writing = true
+
+  // A single writer overwrites random keys for as long as the readers run,
+  // like the db_bench workload of the same name.
+  const writer = (async () => {
+    while (writing) {
+      await ctx.put(() => ctx.randomKey())
+
+      ctx.backgroundOperations += ctx.batchSize
+    }
+  })()
+
+  const step = () => ctx.read()
+
+  step.teardown = async () => {
+    writing = false
+    await writer
+  }
+
+  return step
+}
+
+exports.deleterandom = function deleterandom(ctx) {
+  return async () => {
+    const batch = ctx.db.write()
+    for (let i = 0; i < ctx.batchSize; i++) batch.tryDelete(ctx.randomKey())
+    await batch.flush()
+    batch.destroy()
+
+    ctx.operations += ctx.batchSize
+  }
+}
+
+function mixed(ctx, ratio) {
+  return async () => {
+    if (Math.random() < ratio) await ctx.read()
+    else await ctx.write(() => ctx.randomKey())
+  }
+}
@@ -1,5 +1,6 @@
 const crypto = require('crypto')
 const bench = require('./harness')
+const report = require('./report')
 
 module.exports = async function writeBenchmark(t, db, benchOpts) {
   const test = t.test('Writing')
@@ -18,7 +19,7 @@ module.exports = async function writeBenchmark(t, db, benchOpts) {
     keysWrote++
   }, benchOpts)
 
-  test.comment('Writing performance:', result, 'ops/s')
+  report.record(test, 'Writing', result)
   test.comment('Keys wrote:', keysWrote)
   test.pass()
 
@@ -1,3 +1,5 @@
+#include <atomic>
+#include <deque>
 #include <set>
 
 #include <assert.h>
@@ -15,14 +17,19 @@ using rocksdb_native_on_close_t = js_function_t<void, js_receiver_t>;
 using rocksdb_native_on_suspend_t = js_function_t<void, js_receiver_t, std::optional<js_object_t>>;
 using rocksdb_native_on_resume_t = js_function_t<void, js_receiver_t, std::optional<js_object_t>>;
 using rocksdb_native_on_flush_t = js_function_t<void, js_receiver_t, std::optional<js_object_t>>;
-using rocksdb_native_on_write_t = js_function_t<void, js_receiver_t, std::optional<js_object_t>>;
-using rocksdb_native_on_read_t = js_function_t<void, js_receiver_t, js_array_t, js_array_t>;
+using rocksdb_native_on_write_t = js_function_t<void, js_receiver_t, std::optional<js_object_t>, std::optional<js_arraybuffer_t>>;
+using rocksdb_native_on_read_t = js_function_t<void, js_receiver_t, js_array_t, js_array_t, std::optional<js_arraybuffer_t>>;
 using rocksdb_native_on_iterator_open_t = js_function_t<void, js_receiver_t, std::optional<js_object_t>>;
 using rocksdb_native_on_iterator_close_t = js_function_t<void, js_receiver_t, std::optional<js_object_t>>;
-using rocksdb_native_on_iterator_read_t = js_function_t<void, js_receiver_t, std::optional<js_object_t>, js_array_t, js_array_t>;
+using rocksdb_native_on_iterator_read_t = js_function_t<void, js_receiver_t, std::optional<js_object_t>, js_array_t, js_array_t, std::optional<js_arraybuffer_t>>;
 using rocksdb_native_on_compact_t = js_function_t<void, js_receiver_t, std::optional<js_object_t>>;
 using rocksdb_native_on_compact_range_t = js_function_t<void, js_receiver_t, std::optional<js_object_t>>;
 using rocksdb_native_on_approximate_size_t = js_function_t<void, js_receiver_t, std::optional<js_object_t>, uint64_t>;
+using rocksdb_native_on_key_may_exist_t = js_function_t<void, js_receiver_t, std::optional<js_object_t>>;
+using rocksdb_native_on_table_properties_t = js_function_t<void, js_receiver_t, std::optional<js_object_t>, js_array_t>;
+using rocksdb_native_on_replay_t = js_function_t<void, js_receiver_t, std::optional<js_object_t>, std::optional<js_arraybuffer_t>>;
+using rocksdb_native_on_complete_t = js_function_t<void, js_receiver_t, js_arraybuffer_t, js_array_t>;
+using rocksdb_native_on_event_t = js_function_t<void, js_receiver_t, js_array_t>;
 using rocksdb_native_on_current_wal_file_t = js_function_t<void, js_receiver_t, std::optional<js_object_t>, char *, uint64_t, uint32_t, uint64_t, uint64_t>;
 
 struct rocksdb_native_t;
@@ -33,6 +40,8 @@ struct rocksdb_native_column_family_t {
 
   std::string name;
 
+  std::vector<rocksdb_compression_t> compression_per_level;
+
   rocksdb_native_t *db;
 
   js_persistent_t<js_arraybuffer_t> ctx;
@@ -46,6 +55,156 @@ struct rocksdb_native_snapshot_t {
   js_persistent_t<js_arraybuffer_t> ctx;
 };
 
+struct rocksdb_native_block_cache_t {
+  rocksdb_cache_t handle;
+};
+
+struct rocksdb_native_write_buffer_manager_t {
+  rocksdb_write_buffer_manager_t handle;
+};
+
+struct rocksdb_native_rate_limiter_t {
+  rocksdb_rate_limiter_t handle;
+};
+
+struct rocksdb_native_drop_filter_t {
+  rocksdb_drop_filter_t handle;
+};
+
+enum rocksdb_native_lane_t {
+  rocksdb_native_lane_read,
+  rocksdb_native_lane_write,
+  rocksdb_native_lane_scan,
+  rocksdb_native_lane_maintenance,
+  rocksdb_native_lane_count,
+};
+
+struct rocksdb_native_job_t {
+  rocksdb_req_t *req;
+  rocksdb_work_cb work;
+  rocksdb_after_work_cb after_work;
+};
+
+struct rocksdb_native_executor_state_t;
+
+struct rocksdb_native_worker_t {
+  uv_thread_t thread;
+  rocksdb_native_lane_t lane;
+  rocksdb_native_executor_state_t *executor;
+};
+
+// Each lane has its own workers, which prefer jobs from their own lane but
+// will help out lanes of higher priority when idle, and never the reverse.
+// Point reads are therefore never stuck behind a scan or compaction, while
+// maintenance work can't be starved of its own workers either.
+struct rocksdb_native_executor_state_t {
+  uv_mutex_t lock;
+  uv_cond_t available;
+
+  std::deque<rocksdb_native_job_t> lanes[rocksdb_native_lane_count];
+  std::vector<rocksdb_native_job_t> completed;
+  std::vector<rocksdb_native_worker_t *> workers;
+
+  // Completions are handed back to the loop the executor was created on
+  uv_async_t async;
+
+  js_deferred_teardown_t *teardown;
+
+  size_t pending;
+  bool stopping;
+  bool exiting;
+};
+
+struct rocksdb_native_executor_t {
+  rocksdb_native_executor_state_t *state;
+};
+
+enum rocksdb_native_op_t {
+  rocksdb_native_op_read,
+  rocksdb_native_op_write,
+  rocksdb_native_op_iterator_read,
+  rocksdb_native_op_flush,
+  rocksdb_native_op_compact,
+  rocksdb_native_op_count,
+};
+
+enum rocksdb_native_phase_t {
+  rocksdb_native_phase_queue,
+  rocksdb_native_phase_engine,
+  rocksdb_native_phase_total,
+  rocksdb_native_phase_count,
+};
+
+// Log-linear histogram of microsecond latencies in the style of HDR
+// histograms: every power of two is split into 8 linear sub-buckets, which
+// bounds the relative error of a recorded value to 12.5%.
+#define ROCKSDB_NATIVE_HISTOGRAM_SUB_BITS 3
+#define ROCKSDB_NATIVE_HISTOGRAM_MAX_BITS 36
+#define ROCKSDB_NATIVE_HISTOGRAM_BUCKETS  ((ROCKSDB_NATIVE_HISTOGRAM_MAX_BITS - ROCKSDB_NATIVE_HISTOGRAM_SUB_BITS + 2) << ROCKSDB_NATIVE_HISTOGRAM_SUB_BITS)
+
+struct rocksdb_native_histogram_t {
+  uint64_t count;
+  uint64_t sum;
+  uint64_t min;
+  uint64_t max;
+  uint32_t buckets[ROCKSDB_NATIVE_HISTOGRAM_BUCKETS];
+};
+
+struct rocksdb_native_event_t {
+  rocksdb_event_type_t type;
+
+  std::string column_family;
+  std::string path;
+  std::string message;
+
+  int status;
+  int job_id;
+  int input_level;
+  int output_level;
+
+  uint64_t bytes_read;
+  uint64_t bytes_written;
+  uint64_t elapsed;
+
+  rocksdb_write_stall_condition_t previous_condition;
+  rocksdb_write_stall_condition_t current_condition;
+};
+
+// Events are raised on RocksDB background threads, so they're copied into a
+// queue guarded by a mutex and drained on the loop thread by an async handle.
+// Sends coalesce, so every event raised between two loop iterations reaches
+// JavaScript in a single call.
+struct rocksdb_native_events_t {
+  uv_async_t async;
+  uv_mutex_t lock;
+
+  std::vector<rocksdb_native_event_t> queue;
+
+  rocksdb_native_t *db;
+};
+
+enum rocksdb_native_completion_type_t {
+  rocksdb_native_completion_read,
+  rocksdb_native_completion_write,
+};
+
+struct rocksdb_native_completion_t {
+  rocksdb_native_completion_type_t type;
+  uint32_t id;
+  void *req;
+};
+
+// Successful reads and writes are queued as they finish and handed to
+// JavaScript in a single call from a check handle, which runs once per loop
+// iteration right after the completions have been polled.
+struct rocksdb_native_completions_t {
+  uv_check_t check;
+
+  std::vector<rocksdb_native_completion_t> queue;
+
+  rocksdb_native_t *db;
+};
+
 struct rocksdb_native_t {
   rocksdb_t handle;
   rocksdb_options_t options;
@@ -55,6 +214,13 @@ struct rocksdb_native_t {
 
   js_env_t *env;
   js_persistent_t<js_receiver_t> ctx;
+  js_persistent_t<rocksdb_native_on_event_t> on_event;
+  js_persistent_t<rocksdb_native_on_complete_t> on_complete;
+
+  rocksdb_native_events_t *events;
+  rocksdb_native_completions_t *completions;
+
+  rocksdb_native_executor_state_t *executor;
 
   bool closing;
   bool exiting;
@@ -62,6 +228,8 @@ struct rocksdb_native_t {
   std::set<rocksdb_native_column_family_t *> column_families;
   std::set<rocksdb_native_snapshot_t *> snapshots;
 
+  rocksdb_native_histogram_t latency[rocksdb_native_op_count][rocksdb_native_phase_count];
+
   js_deferred_teardown_t *teardown;
 };
 
@@ -105,6 +273,10 @@ struct rocksdb_native_iterator_t {
   rocksdb_slice_t *keys;
   rocksdb_slice_t *values;
 
+  uint64_t submitted;
+
+  bool perf;
+
   js_env_t *env;
   js_persistent_t<js_receiver_t> ctx;
   js_persistent_t<rocksdb_native_on_iterator_open_t> on_open;
@@ -124,6 +296,11 @@ struct rocksdb_native_read_batch_t {
 
   size_t capacity;
 
+  uint32_t id;
+  uint64_t submitted;
+
+  bool perf;
+
   js_env_t *env;
   js_persistent_t<js_receiver_t> ctx;
   js_persistent_t<rocksdb_native_on_read_t> on_read;
@@ -136,6 +313,12 @@ struct rocksdb_native_write_batch_t {
 
   size_t capacity;
 
+  uint32_t id;
+  uint64_t submitted;
+
+  bool perf;
+  bool no_slowdown;
+
   js_env_t *env;
   js_persistent_t<js_receiver_t> ctx;
   js_persistent_t<rocksdb_native_on_write_t> on_write;
@@ -144,6 +327,8 @@ struct rocksdb_native_write_batch_t {
 struct rocksdb_native_flush_t {
   rocksdb_flush_t handle;
 
+  uint64_t submitted;
+
   js_env_t *env;
   js_persistent_t<js_receiver_t> ctx;
   js_persistent_t<rocksdb_native_on_flush_t> on_flush;
@@ -154,6 +339,10 @@ struct rocksdb_native_flush_t {
 struct rocksdb_native_compact_t {
   rocksdb_compact_t handle;
 
+  std::atomic<bool> canceled;
+
+  uint64_t submitted;
+
   js_env_t *env;
   js_persistent_t<js_receiver_t> ctx;
   js_persistent_t<rocksdb_native_on_compact_t> on_compact;
@@ -162,6 +351,10 @@ struct rocksdb_native_compact_t {
 struct rocksdb_native_compact_range_t {
   rocksdb_compact_range_t handle;
 
+  std::atomic<bool> canceled;
+
+  uint64_t submitted;
+
   js_env_t *env;
   js_persistent_t<js_receiver_t> ctx;
   js_persistent_t<rocksdb_native_on_compact_range_t> on_compact_range;
@@ -175,6 +368,37 @@ struct rocksdb_native_current_wal_file_t {
   js_persistent_t<rocksdb_native_on_current_wal_file_t> on_current_wal_file;
 };
 
+struct rocksdb_native_table_properties_t {
+  rocksdb_table_properties_t handle;
+
+  js_env_t *env;
+  js_persistent_t<js_receiver_t> ctx;
+  js_persistent_t<rocksdb_native_on_table_properties_t> on_table_properties;
+};
+
+enum rocksdb_native_replay_op_t {
+  rocksdb_native_replay_op_get,
+  rocksdb_native_replay_op_write,
+  rocksdb_native_replay_op_seek,
+  rocksdb_native_replay_op_multi_get,
+  rocksdb_native_replay_op_count,
+};
+
+struct rocksdb_native_replay_t {
+  rocksdb_replay_t handle;
+
+  std::vector<rocksdb_column_family_t *> column_families;
+
+  // Results are reported from the replay worker threads
+  uv_mutex_t lock;
+
+  rocksdb_native_histogram_t latency[rocksdb_native_replay_op_count];
+
+  js_env_t *env;
+  js_persistent_t<js_receiver_t> ctx;
+  js_persistent_t<rocksdb_native_on_replay_t> on_replay;
+};
+
 struct rocksdb_native_approximate_size_t {
   rocksdb_approximate_size_t handle;
 
@@ -183,6 +407,16 @@ struct rocksdb_native_approximate_size_t {
   js_persistent_t<rocksdb_native_on_approximate_size_t> on_approximate_size;
 };
 
+struct rocksdb_native_key_may_exist_t {
+  rocksdb_key_may_exist_t handle;
+
+  rocksdb_slice_t *keys;
+
+  js_env_t *env;
+  js_persistent_t<js_receiver_t> ctx;
+  js_persistent_t<rocksdb_native_on_key_may_exist_t> on_key_may_exist;
+};
+
 static void
 rocksdb_native__on_free(js_env_t *env, char *data) {
   free(data);
@@ -203,6 +437,195 @@ rocksdb_native__try_create_external_arraybuffer(js_env_t *env, char *data, size_
   return 0;
 }
 
+static size_t
+rocksdb_native__histogram_index(uint64_t value) {
+  const uint64_t sub_buckets = 1 << ROCKSDB_NATIVE_HISTOGRAM_SUB_BITS;
+
+  if (value < sub_buckets) return value;
+
+  int msb = 0;
+  while (msb < 63 && (value >> (msb + 1)) != 0) msb++;
+
+  if (msb > ROCKSDB_NATIVE_HISTOGRAM_MAX_BITS) return ROCKSDB_NATIVE_HISTOGRAM_BUCKETS - 1;
+
+  int shift = msb - ROCKSDB_NATIVE_HISTOGRAM_SUB_BITS;
+
+  return ((shift + 1) << ROCKSDB_NATIVE_HISTOGRAM_SUB_BITS) + ((value >> shift) - sub_buckets);
+}
+
+static uint64_t
+rocksdb_native__histogram_value(size_t index) {
+  const uint64_t sub_buckets = 1 << ROCKSDB_NATIVE_HISTOGRAM_SUB_BITS;
+
+  if (index < sub_buckets) return index;
+
+  int shift = int(index >> ROCKSDB_NATIVE_HISTOGRAM_SUB_BITS) - 1;
+
+  // Report the upper bound of the bucket
+  return ((sub_buckets + (index & (sub_buckets - 1))) << shift) + (uint64_t(1) << shift) - 1;
+}
+
+static void
+rocksdb_native__histogram_record(rocksdb_native_histogram_t *histogram, uint64_t value) {
+  if (histogram->count == 0 || value < histogram->min) histogram->min = value;
+  if (value > histogram->max) histogram->max = value;
+
+  histogram->count++;
+  histogram->sum += value;
+  histogram->buckets[rocksdb_native__histogram_index(value)]++;
+}
+
+static double
+rocksdb_native__histogram_percentile(const rocksdb_native_histogram_t *histogram, double percentile) {
+  if (histogram->count == 0) return 0;
+
+  auto threshold = uint64_t(percentile * double(histogram->count));
+
+  if (threshold == 0) threshold = 1;
+
+  uint64_t seen = 0;
+
+  for (size_t i = 0; i < ROCKSDB_NATIVE_HISTOGRAM_BUCKETS; i++) {
+    seen += histogram->buckets[i];
+
+    if (seen >= threshold) {
+      auto value = rocksdb_native__histogram_value(i);
+
+      return double(value < histogram->max ? value : histogram->max);
+    }
+  }
+
+  return double(histogram->max);
+}
+
+// Writes count, min, max, mean, p50, p90, p99 and p999 of the histogram
+static void
+rocksdb_native__histogram_summary(const rocksdb_native_histogram_t *histogram, double *data) {
+  data[0] = double(histogram->count);
+  data[1] = double(histogram->min);
+  data[2] = double(histogram->max);
+  data[3] = histogram->count ? double(histogram->sum) / double(histogram->count) : 0;
+  data[4] = rocksdb_native__histogram_percentile(histogram, 0.5);
+  data[5] = rocksdb_native__histogram_percentile(histogram, 0.9);
+  data[6] = rocksdb_native__histogram_percentile(histogram, 0.99);
+  data[7] = rocksdb_native__histogram_percentile(histogram, 0.999);
+}
+
+static void
+rocksdb_native__record_latency(rocksdb_native_t *db, rocksdb_native_op_t op, uint64_t submitted, uint64_t started) {
+  auto completed = uv_hrtime();
+
+  // The worker may not have run at all if the request failed up front
+  if (started < submitted) started = submitted;
+
+  auto histograms = db->latency[op];
+
+  rocksdb_native__histogram_record(&histograms[rocksdb_native_phase_queue], (started - submitted) / 1000);
+  rocksdb_native__histogram_record(&histograms[rocksdb_native_phase_engine], (completed - started) / 1000);
+  rocksdb_native__histogram_record(&histograms[rocksdb_native_phase_total], (completed - submitted) / 1000);
+}
+
+// Perf contexts are handed to JavaScript as 64-bit counters in this order,
+// which is exported as PERF_FIELDS, so decoding never depends on the layout
+// of rocksdb_perf_context_t.
+static const struct {
+  const char *name;
+  uint64_t rocksdb_perf_context_t::*field;
+} rocksdb_native_perf_fields[] = {
+  {"blockReadCount", &rocksdb_perf_context_t::block_read_count},
+  {"blockReadBytes", &rocksdb_perf_context_t::block_read_bytes},
+  {"blockCacheHitCount", &rocksdb_perf_context_t::block_cache_hit_count},
+  {"bloomMemtableHitCount", &rocksdb_perf_context_t::bloom_memtable_hit_count},
+  {"bloomMemtableMissCount", &rocksdb_perf_context_t::bloom_memtable_miss_count},
+  {"bloomSstHitCount", &rocksdb_perf_context_t::bloom_sst_hit_count},
+  {"bloomSstMissCount", &rocksdb_perf_context_t::bloom_sst_miss_count},
+  {"internalDeleteSkippedCount", &rocksdb_perf_context_t::internal_delete_skipped_count},
+  {"internalKeySkippedCount", &rocksdb_perf_context_t::internal_key_skipped_count},
+  {"getFromMemtableTime", &rocksdb_perf_context_t::get_from_memtable_time},
+  {"getFromOutputFilesTime", &rocksdb_perf_context_t::get_from_output_files_time},
+  {"seekInternalSeekTime", &rocksdb_perf_context_t::seek_internal_seek_time},
+  {"writeWalTime", &rocksdb_perf_context_t::write_wal_time},
+  {"writeMemtableTime", &rocksdb_perf_context_t::write_memtable_time},
+  {"bytesRead", &rocksdb_perf_context_t::bytes_read},
+  {"bytesWritten", &rocksdb_perf_context_t::bytes_written},
+};
+
+static const uint32_t rocksdb_native_perf_field_count = sizeof(rocksdb_native_perf_fields) / sizeof(rocksdb_native_perf_fields[0]);
+
+static const char *
+rocksdb_native_perf_field_name(uint32_t i) {
+  return rocksdb_native_perf_fields[i].name;
+}
+
+static void
+rocksdb_native__create_perf_context(js_env_t *env, const rocksdb_perf_context_t *context, std::optional<js_arraybuffer_t> &result) {
+  int err;
+
+  uint64_t *data;
+  err = js_create_arraybuffer(env, rocksdb_native_perf_field_count, data, result.emplace());
+  assert(err == 0);
+
+  for (uint32_t i = 0; i < rocksdb_native_perf_field_count; i++) {
+    data[i] = context->*rocksdb_native_perf_fields[i].field;
+  }
+}
+
+static void
+rocksdb_native__on_events_close(uv_handle_t *handle) {
+  auto events = reinterpret_cast<rocksdb_native_events_t *>(handle->data);
+
+  uv_mutex_destroy(&events->lock);
+
+  delete events;
+}
+
+static void
+rocksdb_native__close_events(rocksdb_native_t *db) {
+  auto events = db->events;
+
+  if (events == nullptr) return;
+
+  events->db = nullptr;
+
+  uv_close(reinterpret_cast<uv_handle_t *>(&events->async), rocksdb_native__on_events_close);
+
+  db->events = nullptr;
+  db->options.on_event = nullptr;
+  db->on_event.reset();
+}
+
+static void
+rocksdb_native__on_completions_close(uv_handle_t *handle) {
+  auto completions = reinterpret_cast<rocksdb_native_completions_t *>(handle->data);
+
+  delete completions;
+}
+
+static void
+rocksdb_native__close_completions(rocksdb_native_t *db) {
+  auto completions = db->completions;
+
+  if (completions == nullptr) return;
+
+  // Release anything that finished after the final loop iteration
+  for (auto &completion : completions->queue) {
+    if (completion.type == rocksdb_native_completion_write) continue;
+
+    auto req = reinterpret_cast<rocksdb_native_read_batch_t *>(completion.req);
+
+    for (size_t i = 0, n = req->handle.len; i < n; i++) {
+      rocksdb_slice_destroy(&req->reads[i].value);
+    }
+
+    rocksdb_read_cleanup(&req->handle);
+  }
+
+  uv_close(reinterpret_cast<uv_handle_t *>(&completions->check), rocksdb_native__on_completions_close);
+
+  db->completions = nullptr;
+  db->on_complete.reset();
+}
+
 static void
 rocksdb_native__on_open(rocksdb_open_t *handle, int status) {
   int err;
@@ -243,6 +666,9 @@ rocksdb_native__on_open(rocksdb_open_t *handle, int status) {
   if (req->handle.error) {
     err = js_create_error(env, uv_err_name(req->handle.status), req->handle.error, error.emplace());
     assert(err == 0);
+
+    rocksdb_native__close_events(db);
+    rocksdb_native__close_completions(db);
   } else {
     std::vector<js_arraybuffer_t> elements;
     err = js_get_array_elements(env, column_families, elements);
@@ -297,6 +723,8 @@ rocksdb_native__on_idle(rocksdb_t *handle) {
 
     column_family->name.~basic_string();
 
+    column_family->compression_per_level.~vector();
+
     column_family->ctx.reset();
   }
 
@@ -322,112 +750,324 @@ rocksdb_native__on_idle(rocksdb_t *handle) {
 }
 
 static void
-rocksdb_native__on_close(rocksdb_close_t *handle, int status) {
-  int err;
-
-  assert(status == 0);
-
-  auto req = reinterpret_cast<rocksdb_native_close_t *>(handle->data);
-
-  auto db = reinterpret_cast<rocksdb_native_t *>(req->handle.req.db);
+rocksdb_native__on_event(rocksdb_t *handle, const rocksdb_event_t *event) {
+  auto db = reinterpret_cast<rocksdb_native_t *>(handle);
 
-  auto env = req->env;
+  auto events = db->events;
 
-  auto teardown = db->teardown;
+  rocksdb_native_event_t copy;
 
-  rocksdb_close_cleanup(&req->handle);
+  copy.type = event->type;
+  copy.column_family = event->column_family ? event->column_family : "";
+  copy.path = event->path ? event->path : "";
+  copy.message = event->error ? event->error : "";
+  copy.status = event->status;
+  copy.job_id = event->job_id;
+  copy.input_level = event->input_level;
+  copy.output_level = event->output_level;
+  copy.bytes_read = event->bytes_read;
+  copy.bytes_written = event->bytes_written;
+  copy.elapsed = event->elapsed;
+  copy.previous_condition = event->previous_condition;
+  copy.current_condition = event->current_condition;
 
-  if (db->closing) {
-    js_handle_scope_t *scope;
-    err = js_open_handle_scope(env, &scope);
-    assert(err == 0);
+  uv_mutex_lock(&events->lock);
 
-    js_receiver_t ctx;
-    err = js_get_reference_value(env, req->ctx, ctx);
-    assert(err == 0);
+  events->queue.push_back(std::move(copy));
 
-    rocksdb_native_on_close_t cb;
-    err = js_get_reference_value(env, req->on_close, cb);
-    assert(err == 0);
+  uv_mutex_unlock(&events->lock);
 
-    req->on_close.reset();
-    req->ctx.reset();
+  uv_async_send(&events->async);
+}
 
-    if (!db->exiting) {
-      err = js_call_function_with_checkpoint(env, cb, ctx);
-      (void) err;
-    }
+static void
+rocksdb_native__on_events(uv_async_t *handle) {
+  int err;
 
-    err = js_close_handle_scope(env, scope);
-    assert(err == 0);
-  } else {
-    delete req;
-  }
+  auto events = reinterpret_cast<rocksdb_native_events_t *>(handle->data);
 
-  db->ctx.reset();
+  auto db = events->db;
 
-  err = js_finish_deferred_teardown_callback(teardown);
-  assert(err == 0);
-}
+  std::vector<rocksdb_native_event_t> queue;
 
-static void
-rocksdb_native__on_teardown(js_deferred_teardown_t *teardown, void *data) {
-  int err;
+  uv_mutex_lock(&events->lock);
 
-  auto db = reinterpret_cast<rocksdb_native_t *>(data);
+  queue.swap(events->queue);
 
-  db->exiting = true;
+  uv_mutex_unlock(&events->lock);
 
-  if (db->closing) return;
+  if (db == nullptr || db->exiting || queue.empty()) return;
 
   auto env = db->env;
 
-  auto req = new rocksdb_native_close_t();
-
-  req->env = env;
-  req->handle.data = req;
+  js_handle_scope_t *scope;
+  err = js_open_handle_scope(env, &scope);
+  assert(err == 0);
 
-  err = rocksdb_close(&db->handle, &req->handle, rocksdb_native__on_idle, rocksdb_native__on_close);
+  js_receiver_t ctx;
+  err = js_get_reference_value(env, db->ctx, ctx);
   assert(err == 0);
-}
 
-static js_arraybuffer_t
-rocksdb_native_init(
-  js_env_t *env,
-  bool read_only,
-  bool create_if_missing,
-  bool create_missing_column_families,
-  int32_t max_background_jobs,
-  uint64_t bytes_per_sync,
-  int32_t max_open_files,
-  bool use_direct_reads,
-  bool avoid_unnecessary_blocking_io,
-  bool skip_stats_update_on_db_open,
-  bool use_direct_io_for_flush_and_compaction,
-  int32_t max_file_opening_threads,
-  uint32_t wal_recovery_mode,
-  bool best_efforts_recovery,
-  bool enable_statistics,
-  uint32_t stats_level,
-  uint64_t wal_ttl_seconds,
-  uint64_t wal_size_limit_mb,
-  bool avoid_flush_during_shutdown,
-  js_array_t wal_filter_prefixes_array
-) {
-  int err;
+  rocksdb_native_on_event_t cb;
+  err = js_get_reference_value(env, db->on_event, cb);
+  assert(err == 0);
 
-  std::vector<js_typedarray_t<>> prefix_elements;
-  err = js_get_array_elements(env, wal_filter_prefixes_array, prefix_elements);
+  js_array_t result;
+  err = js_create_array(env, queue.size(), result);
   assert(err == 0);
 
-  const auto wal_filter_prefixes_len = prefix_elements.size();
+  for (size_t i = 0, n = queue.size(); i < n; i++) {
+    auto &event = queue[i];
 
-  rocksdb_slice_t *wal_filter_prefixes = nullptr;
+    js_object_t value;
+    err = js_create_object(env, value);
+    assert(err == 0);
 
-  if (wal_filter_prefixes_len > 0) {
-    wal_filter_prefixes = reinterpret_cast<rocksdb_slice_t *>(malloc(wal_filter_prefixes_len * sizeof(rocksdb_slice_t)));
+    switch (event.type) {
+    case rocksdb_event_flush_completed:
+      err = js_set_property(env, value, "type", "flush");
+      assert(err == 0);
 
-    for (size_t i = 0; i < wal_filter_prefixes_len; i++) {
+      err = js_set_property(env, value, "columnFamily", event.column_family);
+      assert(err == 0);
+
+      err = js_set_property(env, value, "path", event.path);
+      assert(err == 0);
+
+      err = js_set_property(env, value, "jobId", event.job_id);
+      assert(err == 0);
+
+      err = js_set_property(env, value, "bytesWritten", event.bytes_written);
+      assert(err == 0);
+      break;
+
+    case rocksdb_event_compaction_completed:
+      err = js_set_property(env, value, "type", "compaction");
+      assert(err == 0);
+
+      err = js_set_property(env, value, "columnFamily", event.column_family);
+      assert(err == 0);
+
+      err = js_set_property(env, value, "jobId", event.job_id);
+      assert(err == 0);
+
+      err = js_set_property(env, value, "inputLevel", event.input_level);
+      assert(err == 0);
+
+      err = js_set_property(env, value, "outputLevel", event.output_level);
+      assert(err == 0);
+
+      err = js_set_property(env, value, "bytesRead", event.bytes_read);
+      assert(err == 0);
+
+      err = js_set_property(env, value, "bytesWritten", event.bytes_written);
+      assert(err == 0);
+
+      err = js_set_property(env, value, "elapsed", event.elapsed);
+      assert(err == 0);
+      break;
+
+    case rocksdb_event_stall_conditions_changed:
+      err = js_set_property(env, value, "type", "stall");
+      assert(err == 0);
+
+      err = js_set_property(env, value, "columnFamily", event.column_family);
+      assert(err == 0);
+
+      err = js_set_property(env, value, "previous", uint32_t(event.previous_condition));
+      assert(err == 0);
+
+      err = js_set_property(env, value, "current", uint32_t(event.current_condition));
+      assert(err == 0);
+      break;
+
+    case rocksdb_event_background_error: {
+      err = js_set_property(env, value, "type", "background-error");
+      assert(err == 0);
+
+      js_object_t error;
+      err = js_create_error(env, uv_err_name(event.status), event.message.c_str(), error);
+      assert(err == 0);
+
+      err = js_set_property(env, value, "error", error);
+      assert(err == 0);
+      break;
+    }
+
+    case rocksdb_event_table_file_deleted:
+      err = js_set_property(env, value, "type", "file-deleted");
+      assert(err == 0);
+
+      err = js_set_property(env, value, "path", event.path);
+      assert(err == 0);
+
+      err = js_set_property(env, value, "jobId", event.job_id);
+      assert(err == 0);
+      break;
+    }
+
+    err = js_set_element(env, result, i, value);
+    assert(err == 0);
+  }
+
+  err = js_call_function_with_checkpoint(env, cb, ctx, result);
+  (void) err;
+
+  err = js_close_handle_scope(env, scope);
+  assert(err == 0);
+}
+
+static void
+rocksdb_native__on_close(rocksdb_close_t *handle, int status) {
+  int err;
+
+  assert(status == 0);
+
+  auto req = reinterpret_cast<rocksdb_native_close_t *>(handle->data);
+
+  auto db = reinterpret_cast<rocksdb_native_t *>(req->handle.req.db);
+
+  auto env = req->env;
+
+  auto teardown = db->teardown;
+
+  rocksdb_close_cleanup(&req->handle);
+
+  if (db->closing) {
+    js_handle_scope_t *scope;
+    err = js_open_handle_scope(env, &scope);
+    assert(err == 0);
+
+    js_receiver_t ctx;
+    err = js_get_reference_value(env, req->ctx, ctx);
+    assert(err == 0);
+
+    rocksdb_native_on_close_t cb;
+    err = js_get_reference_value(env, req->on_close, cb);
+    assert(err == 0);
+
+    req->on_close.reset();
+    req->ctx.reset();
+
+    if (!db->exiting) {
+      err = js_call_function_with_checkpoint(env, cb, ctx);
+      (void) err;
+    }
+
+    err = js_close_handle_scope(env, scope);
+    assert(err == 0);
+  } else {
+    delete req;
+  }
+
+  rocksdb_native__close_events(db);
+  rocksdb_native__close_completions(db);
+
+  db->ctx.reset();
+
+  err = js_finish_deferred_teardown_callback(teardown);
+  assert(err == 0);
+}
+
+static void
+rocksdb_native__on_teardown(js_deferred_teardown_t *teardown, void *data) {
+  int err;
+
+  auto db = reinterpret_cast<rocksdb_native_t *>(data);
+
+  db->exiting = true;
+
+  if (db->closing) return;
+
+  auto env = db->env;
+
+  auto req = new rocksdb_native_close_t();
+
+  req->env = env;
+  req->handle.data = req;
+
+  err = rocksdb_close(&db->handle, &req->handle, rocksdb_native__on_idle, rocksdb_native__on_close);
+  assert(err == 0);
+}
+
+static int
+rocksdb_native__queue_work(rocksdb_t *handle, rocksdb_req_t *req, rocksdb_work_type_t type, rocksdb_work_cb work, rocksdb_after_work_cb after_work) {
+  auto db = reinterpret_cast<rocksdb_native_t *>(handle);
+
+  auto executor = db->executor;
+
+  rocksdb_native_lane_t lane;
+
+  switch (type) {
+  case rocksdb_work_read:
+    lane = rocksdb_native_lane_read;
+    break;
+  case rocksdb_work_write:
+    lane = rocksdb_native_lane_write;
+    break;
+  case rocksdb_work_iterator:
+    lane = rocksdb_native_lane_scan;
+    break;
+  default:
+    lane = rocksdb_native_lane_maintenance;
+    break;
+  }
+
+  uv_mutex_lock(&executor->lock);
+
+  executor->lanes[lane].push_back({req, work, after_work});
+
+  uv_cond_broadcast(&executor->available);
+
+  uv_mutex_unlock(&executor->lock);
+
+  // Only keep the loop alive while there's outstanding work
+  if (executor->pending++ == 0) uv_ref(reinterpret_cast<uv_handle_t *>(&executor->async));
+
+  return 0;
+}
+
+static js_arraybuffer_t
+rocksdb_native_init(
+  js_env_t *env,
+  bool read_only,
+  bool create_if_missing,
+  bool create_missing_column_families,
+  int32_t max_background_jobs,
+  uint64_t bytes_per_sync,
+  int32_t max_open_files,
+  bool use_direct_reads,
+  bool avoid_unnecessary_blocking_io,
+  bool skip_stats_update_on_db_open,
+  bool use_direct_io_for_flush_and_compaction,
+  int32_t max_file_opening_threads,
+  uint32_t wal_recovery_mode,
+  bool best_efforts_recovery,
+  bool enable_statistics,
+  uint32_t stats_level,
+  uint64_t wal_ttl_seconds,
+  uint64_t wal_size_limit_mb,
+  bool avoid_flush_during_shutdown,
+  js_array_t wal_filter_prefixes_array,
+  std::optional<js_arraybuffer_span_of_t<rocksdb_native_write_buffer_manager_t, 1>> write_buffer_manager,
+  std::optional<js_arraybuffer_span_of_t<rocksdb_native_rate_limiter_t, 1>> rate_limiter,
+  uint64_t row_cache_capacity,
+  std::optional<js_arraybuffer_span_of_t<rocksdb_native_executor_t, 1>> executor
+) {
+  int err;
+
+  std::vector<js_typedarray_t<>> prefix_elements;
+  err = js_get_array_elements(env, wal_filter_prefixes_array, prefix_elements);
+  assert(err == 0);
+
+  const auto wal_filter_prefixes_len = prefix_elements.size();
+
+  rocksdb_slice_t *wal_filter_prefixes = nullptr;
+
+  if (wal_filter_prefixes_len > 0) {
+    wal_filter_prefixes = reinterpret_cast<rocksdb_slice_t *>(malloc(wal_filter_prefixes_len * sizeof(rocksdb_slice_t)));
+
+    for (size_t i = 0; i < wal_filter_prefixes_len; i++) {
       rocksdb_slice_t prefix;
       err = js_get_typedarray_info(env, prefix_elements[i], prefix.data, prefix.len);
       assert(err == 0);
@@ -447,6 +1087,9 @@ rocksdb_native_init(
   assert(err == 0);
 
   db->env = env;
+  db->events = nullptr;
+  db->completions = nullptr;
+  db->executor = nullptr;
   db->closing = false;
   db->exiting = false;
 
@@ -456,7 +1099,9 @@ rocksdb_native_init(
   new (&db->column_families) std::set<rocksdb_native_column_family_t *>();
   new (&db->snapshots) std::set<rocksdb_native_snapshot_t *>();
 
-  rocksdb_options_init(&db->options, 8);
+  memset(db->latency, 0, sizeof(db->latency));
+
+  rocksdb_options_init(&db->options, 12);
 
   db->options.read_only = read_only;
   db->options.create_if_missing = create_if_missing;
@@ -480,6 +1125,17 @@ rocksdb_native_init(
   db->options.wal_filter_prefixes = db->wal_filter_prefixes;
   db->options.wal_filter_prefixes_len = db->wal_filter_prefixes_len;
 
+  if (write_buffer_manager) db->options.write_buffer_manager = &write_buffer_manager.value()->handle;
+
+  if (rate_limiter) db->options.rate_limiter = &rate_limiter.value()->handle;
+
+  db->options.row_cache_capacity = row_cache_capacity;
+
+  if (executor) {
+    db->executor = executor.value()->state;
+    db->options.queue_work = rocksdb_native__queue_work;
+  }
+
   return handle;
 }
 
@@ -492,7 +1148,11 @@ rocksdb_native_open(
   js_array_t column_families_array,
   int lock,
   js_receiver_t ctx,
-  rocksdb_native_on_open_t on_open
+  rocksdb_native_on_open_t on_open,
+  bool background_events,
+  rocksdb_native_on_event_t on_event,
+  bool batch_completions,
+  rocksdb_native_on_complete_t on_complete
 ) {
   int err;
 
@@ -533,12 +1193,46 @@ rocksdb_native_open(
 
   db->options.lock = lock;
 
+  if (background_events) {
+    auto events = new rocksdb_native_events_t();
+
+    events->db = db;
+    events->async.data = events;
+
+    err = uv_async_init(loop, &events->async, rocksdb_native__on_events);
+    assert(err == 0);
+
+    // Don't let a quiet database keep the loop alive
+    uv_unref(reinterpret_cast<uv_handle_t *>(&events->async));
+
+    err = uv_mutex_init(&events->lock);
+    assert(err == 0);
+
+    db->events = events;
+    db->options.on_event = rocksdb_native__on_event;
+  }
+
+  if (batch_completions) {
+    auto completions = new rocksdb_native_completions_t();
+
+    completions->db = db;
+    completions->check.data = completions;
+
+    err = uv_check_init(loop, &completions->check);
+    assert(err == 0);
+
+    db->completions = completions;
+  }
+
   err = rocksdb_open(loop, &db->handle, &req->handle, path.c_str(), &db->options, column_families, handles, len, nullptr, rocksdb_native__on_open);
 
   if (err < 0) {
     err = js_throw_error(env, uv_err_name(err), uv_strerror(err));
     assert(err == 0);
 
+    rocksdb_native__close_events(db);
+    rocksdb_native__close_completions(db);
+
     if (lock >= 0) {
       uv_fs_t fs;
       err = uv_fs_close(NULL, &fs, lock, NULL);
@@ -551,6 +1245,16 @@ rocksdb_native_open(
   err = js_create_reference(env, self, db->ctx);
   assert(err == 0);
 
+  if (background_events) {
+    err = js_create_reference(env, on_event, db->on_event);
+    assert(err == 0);
+  }
+
+  if (batch_completions) {
+    err = js_create_reference(env, on_complete, db->on_complete);
+    assert(err == 0);
+  }
+
   err = js_create_reference(env, ctx, req->ctx);
   assert(err == 0);
 
@@ -767,170 +1471,1518 @@ rocksdb_native_resume(
 }
 
 static js_arraybuffer_t
-rocksdb_native_column_family_init(
+rocksdb_native_block_cache_init(
   js_env_t *env,
-  std::string name,
-  bool enable_blob_files,
-  uint64_t min_blob_size,
-  uint64_t blob_file_size,
-  bool enable_blob_garbage_collection,
-  uint64_t block_size,
-  bool cache_index_and_filter_blocks,
-  uint32_t format_version,
-  bool optimize_filters_for_memory,
-  bool no_block_cache,
-  uint32_t filter_policy_type,
-  double bits_per_key,
-  int32_t bloom_before_level,
-  uint32_t top_level_index_pinning_tier,
-  uint32_t partition_pinning_tier,
-  uint32_t unpartitioned_pinning_tier,
-  bool optimize_filters_for_hits,
-  int32_t num_levels,
-  int32_t max_write_buffer_number,
-  double blob_garbage_collection_age_cutoff,
-  double blob_garbage_collection_force_threshold
+  uint32_t type,
+  uint64_t capacity,
+  int32_t num_shard_bits,
+  bool strict_capacity_limit
 ) {
   int err;
 
-  rocksdb_filter_policy_t filter_policy = {rocksdb_filter_policy_type_t(filter_policy_type)};
+  js_arraybuffer_t handle;
 
-  switch (filter_policy_type) {
-  case rocksdb_bloom_filter_policy:
-    filter_policy.bloom = (rocksdb_bloom_filter_options_t) {
-      0,
-      bits_per_key
-    };
-    break;
+  rocksdb_native_block_cache_t *cache;
+  err = js_create_arraybuffer(env, cache, handle);
+  assert(err == 0);
 
-  case rocksdb_ribbon_filter_policy:
-    filter_policy.ribbon = (rocksdb_ribbon_filter_options_t) {
-      0,
-      bits_per_key,
-      bloom_before_level,
-    };
-    break;
-  }
+  rocksdb_cache_options_t options;
+  rocksdb_cache_options_init(&options, 0);
 
-  uv_loop_t *loop;
-  err = js_get_env_loop(env, &loop);
-  assert(err == 0);
+  options.type = rocksdb_cache_type_t(type);
+  options.capacity = capacity;
+  options.num_shard_bits = num_shard_bits;
+  options.strict_capacity_limit = strict_capacity_limit;
 
-  js_arraybuffer_t handle;
+  err = rocksdb_cache_init(&cache->handle, &options);
 
-  rocksdb_native_column_family_t *column_family;
-  err = js_create_arraybuffer(env, column_family, handle);
+  if (err < 0) {
+    err = js_throw_error(env, uv_err_name(err), uv_strerror(err));
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  return handle;
+}
+
+static void
+rocksdb_native_block_cache_destroy(
+  js_env_t *env,
+  js_arraybuffer_span_of_t<rocksdb_native_block_cache_t, 1> cache
+) {
+  rocksdb_cache_destroy(&cache->handle);
+}
+
+static uint64_t
+rocksdb_native_block_cache_capacity(
+  js_env_t *env,
+  js_arraybuffer_span_of_t<rocksdb_native_block_cache_t, 1> cache
+) {
+  return rocksdb_cache_capacity(&cache->handle);
+}
+
+static void
+rocksdb_native_block_cache_set_capacity(
+  js_env_t *env,
+  js_arraybuffer_span_of_t<rocksdb_native_block_cache_t, 1> cache,
+  uint64_t capacity
+) {
+  rocksdb_cache_set_capacity(&cache->handle, capacity);
+}
+
+static uint64_t
+rocksdb_native_block_cache_usage(
+  js_env_t *env,
+  js_arraybuffer_span_of_t<rocksdb_native_block_cache_t, 1> cache
+) {
+  return rocksdb_cache_usage(&cache->handle);
+}
+
+static uint64_t
+rocksdb_native_block_cache_pinned_usage(
+  js_env_t *env,
+  js_arraybuffer_span_of_t<rocksdb_native_block_cache_t, 1> cache
+) {
+  return rocksdb_cache_pinned_usage(&cache->handle);
+}
+
+static js_arraybuffer_t
+rocksdb_native_write_buffer_manager_init(
+  js_env_t *env,
+  uint64_t buffer_size,
+  std::optional<js_arraybuffer_span_of_t<rocksdb_native_block_cache_t, 1>> cache,
+  bool allow_stall
+) {
+  int err;
+
+  js_arraybuffer_t handle;
+
+  rocksdb_native_write_buffer_manager_t *manager;
+  err = js_create_arraybuffer(env, manager, handle);
   assert(err == 0);
 
-  column_family->db = nullptr;
-  column_family->handle = nullptr;
+  rocksdb_write_buffer_manager_options_t options;
+  rocksdb_write_buffer_manager_options_init(&options, 0);
 
-  new (&column_family->name) std::string(std::move(name));
+  options.buffer_size = buffer_size;
+  options.allow_stall = allow_stall;
 
-  column_family->descriptor = (rocksdb_column_family_descriptor_t) {
-    column_family->name.c_str(),
-    {
-      5,
-      rocksdb_level_compaction,
-      enable_blob_files,
-      min_blob_size,
-      blob_file_size,
-      enable_blob_garbage_collection,
-      block_size,
-      cache_index_and_filter_blocks,
-      format_version,
-      optimize_filters_for_memory,
-      no_block_cache,
-      filter_policy,
-      rocksdb_pinning_tier_t(top_level_index_pinning_tier),
-      rocksdb_pinning_tier_t(partition_pinning_tier),
-      rocksdb_pinning_tier_t(unpartitioned_pinning_tier),
-      optimize_filters_for_hits,
-      num_levels,
-      max_write_buffer_number,
-      blob_garbage_collection_age_cutoff,
-      blob_garbage_collection_force_threshold,
+  if (cache) options.cache = &cache.value()->handle;
+
+  err = rocksdb_write_buffer_manager_init(&manager->handle, &options);
+
+  if (err < 0) {
+    err = js_throw_error(env, uv_err_name(err), uv_strerror(err));
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  return handle;
+}
+
+static void
+rocksdb_native_write_buffer_manager_destroy(
+  js_env_t *env,
+  js_arraybuffer_span_of_t<rocksdb_native_write_buffer_manager_t, 1> manager
+) {
+  rocksdb_write_buffer_manager_destroy(&manager->handle);
+}
+
+static uint64_t
+rocksdb_native_write_buffer_manager_buffer_size(
+  js_env_t *env,
+  js_arraybuffer_span_of_t<rocksdb_native_write_buffer_manager_t, 1> manager
+) {
+  return rocksdb_write_buffer_manager_buffer_size(&manager->handle);
+}
+
+static void
+rocksdb_native_write_buffer_manager_set_buffer_size(
+  js_env_t *env,
+  js_arraybuffer_span_of_t<rocksdb_native_write_buffer_manager_t, 1> manager,
+  uint64_t buffer_size
+) {
+  rocksdb_write_buffer_manager_set_buffer_size(&manager->handle, buffer_size);
+}
+
+static uint64_t
+rocksdb_native_write_buffer_manager_memory_usage(
+  js_env_t *env,
+  js_arraybuffer_span_of_t<rocksdb_native_write_buffer_manager_t, 1> manager
+) {
+  return rocksdb_write_buffer_manager_memory_usage(&manager->handle);
+}
+
+static bool
+rocksdb_native_write_buffer_manager_stalled(
+  js_env_t *env,
+  js_arraybuffer_span_of_t<rocksdb_native_write_buffer_manager_t, 1> manager
+) {
+  return rocksdb_write_buffer_manager_stalled(&manager->handle);
+}
+
+static js_arraybuffer_t
+rocksdb_native_rate_limiter_init(
+  js_env_t *env,
+  int64_t bytes_per_second,
+  int64_t refill_period,
+  int32_t fairness,
+  uint32_t mode,
+  bool auto_tuned
+) {
+  int err;
+
+  js_arraybuffer_t handle;
+
+  rocksdb_native_rate_limiter_t *limiter;
+  err = js_create_arraybuffer(env, limiter, handle);
+  assert(err == 0);
+
+  rocksdb_rate_limiter_options_t options;
+  rocksdb_rate_limiter_options_init(&options, 0);
+
+  options.bytes_per_second = bytes_per_second;
+  options.refill_period = refill_period;
+  options.fairness = fairness;
+  options.mode = rocksdb_rate_limiter_mode_t(mode);
+  options.auto_tuned = auto_tuned;
+
+  err = rocksdb_rate_limiter_init(&limiter->handle, &options);
+
+  if (err < 0) {
+    err = js_throw_error(env, uv_err_name(err), uv_strerror(err));
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  return handle;
+}
+
+static void
+rocksdb_native_rate_limiter_destroy(
+  js_env_t *env,
+  js_arraybuffer_span_of_t<rocksdb_native_rate_limiter_t, 1> limiter
+) {
+  rocksdb_rate_limiter_destroy(&limiter->handle);
+}
+
+static int64_t
+rocksdb_native_rate_limiter_bytes_per_second(
+  js_env_t *env,
+  js_arraybuffer_span_of_t<rocksdb_native_rate_limiter_t, 1> limiter
+) {
+  return rocksdb_rate_limiter_bytes_per_second(&limiter->handle);
+}
+
+static void
+rocksdb_native_rate_limiter_set_bytes_per_second(
+  js_env_t *env,
+  js_arraybuffer_span_of_t<rocksdb_native_rate_limiter_t, 1> limiter,
+  int64_t bytes_per_second
+) {
+  int err;
+
+  err = rocksdb_rate_limiter_set_bytes_per_second(&limiter->handle, bytes_per_second);
+
+  if (err < 0) {
+    err = js_throw_error(env, uv_err_name(err), uv_strerror(err));
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+}
+
+static int64_t
+rocksdb_native_rate_limiter_total_bytes_through(
+  js_env_t *env,
+  js_arraybuffer_span_of_t<rocksdb_native_rate_limiter_t, 1> limiter,
+  uint32_t priority
+) {
+  return rocksdb_rate_limiter_total_bytes_through(&limiter->handle, rocksdb_io_priority_t(priority));
+}
+
+static int64_t
+rocksdb_native_rate_limiter_total_requests(
+  js_env_t *env,
+  js_arraybuffer_span_of_t<rocksdb_native_rate_limiter_t, 1> limiter,
+  uint32_t priority
+) {
+  return rocksdb_rate_limiter_total_requests(&limiter->handle, rocksdb_io_priority_t(priority));
+}
+
+static void
+rocksdb_native__executor_work(void *data) {
+  auto worker = reinterpret_cast<rocksdb_native_worker_t *>(data);
+
+  auto executor = worker->executor;
+
+  uv_mutex_lock(&executor->lock);
+
+  while (true) {
+    rocksdb_native_job_t job;
+
+    bool found = false;
+
+    for (int lane = worker->lane; lane >= 0 && !found; lane--) {
+      auto &queue = executor->lanes[lane];
+
+      if (queue.empty()) continue;
+
+      job = queue.front();
+      queue.pop_front();
+
+      found = true;
     }
-  };
+
+    if (!found) {
+      if (executor->stopping) break;
+
+      uv_cond_wait(&executor->available, &executor->lock);
+
+      continue;
+    }
+
+    uv_mutex_unlock(&executor->lock);
+
+    job.work(job.req);
+
+    uv_mutex_lock(&executor->lock);
+
+    executor->completed.push_back(job);
+
+    uv_async_send(&executor->async);
+  }
+
+  uv_mutex_unlock(&executor->lock);
+}
+
+static void
+rocksdb_native__on_executor_close(uv_handle_t *handle) {
+  auto executor = reinterpret_cast<rocksdb_native_executor_state_t *>(handle->data);
+
+  uv_cond_destroy(&executor->available);
+  uv_mutex_destroy(&executor->lock);
+
+  delete executor;
+}
+
+static void
+rocksdb_native__executor_stop(rocksdb_native_executor_state_t *executor) {
+  int err;
+
+  uv_mutex_lock(&executor->lock);
+
+  executor->stopping = true;
+
+  uv_cond_broadcast(&executor->available);
+
+  uv_mutex_unlock(&executor->lock);
+
+  for (auto worker : executor->workers) {
+    err = uv_thread_join(&worker->thread);
+    assert(err == 0);
+
+    delete worker;
+  }
+
+  executor->workers.clear();
+
+  auto teardown = executor->teardown;
+
+  uv_close(reinterpret_cast<uv_handle_t *>(&executor->async), rocksdb_native__on_executor_close);
+
+  err = js_finish_deferred_teardown_callback(teardown);
+  assert(err == 0);
+}
+
+static void
+rocksdb_native__on_executor_completed(uv_async_t *handle) {
+  auto executor = reinterpret_cast<rocksdb_native_executor_state_t *>(handle->data);
+
+  std::vector<rocksdb_native_job_t> completed;
+
+  uv_mutex_lock(&executor->lock);
+
+  completed.swap(executor->completed);
+
+  uv_mutex_unlock(&executor->lock);
+
+  if (completed.empty()) return;
+
+  executor->pending -= completed.size();
+
+  if (executor->pending == 0) uv_unref(reinterpret_cast<uv_handle_t *>(&executor->async));
+
+  for (auto &job : completed) {
+    job.after_work(job.req, 0);
+  }
+
+  // The databases closing at exit may still have had work queued when the
+  // environment was torn down, so the executor stops once they're done.
+  if (executor->exiting && executor->pending == 0) rocksdb_native__executor_stop(executor);
+}
+
+static void
+rocksdb_native__on_executor_teardown(js_deferred_teardown_t *teardown, void *data) {
+  auto executor = reinterpret_cast<rocksdb_native_executor_state_t *>(data);
+
+  executor->exiting = true;
+
+  if (executor->pending == 0) rocksdb_native__executor_stop(executor);
+}
+
+static js_arraybuffer_t
+rocksdb_native_executor_init(
+  js_env_t *env,
+  uint32_t reads,
+  uint32_t writes,
+  uint32_t scans,
+  uint32_t maintenance
+) {
+  int err;
+
+  uint32_t sizes[rocksdb_native_lane_count] = {reads, writes, scans, maintenance};
+
+  // Workers also serve the lanes below their own, so a lane is only left
+  // unserved if neither it nor any lane above it has workers.
+  uint32_t workers = 0;
+
+  for (int lane = rocksdb_native_lane_count - 1; lane >= 0; lane--) {
+    workers += sizes[lane];
+
+    if (workers == 0) {
+      err = js_throw_error(env, uv_err_name(UV_EINVAL), "Executor lane has no workers to serve it");
+      assert(err == 0);
+
+      throw js_pending_exception;
+    }
+  }
+
+  uv_loop_t *loop;
+  err = js_get_env_loop(env, &loop);
+  assert(err == 0);
+
+  js_arraybuffer_t handle;
+
+  rocksdb_native_executor_t *wrapper;
+  err = js_create_arraybuffer(env, wrapper, handle);
+  assert(err == 0);
+
+  auto executor = new rocksdb_native_executor_state_t();
+
+  executor->pending = 0;
+  executor->stopping = false;
+  executor->exiting = false;
+  executor->async.data = executor;
+
+  err = uv_mutex_init(&executor->lock);
+  assert(err == 0);
+
+  err = uv_cond_init(&executor->available);
+  assert(err == 0);
+
+  err = uv_async_init(loop, &executor->async, rocksdb_native__on_executor_completed);
+  assert(err == 0);
+
+  uv_unref(reinterpret_cast<uv_handle_t *>(&executor->async));
+
+  for (int lane = 0; lane < rocksdb_native_lane_count; lane++) {
+    for (uint32_t i = 0; i < sizes[lane]; i++) {
+      auto worker = new rocksdb_native_worker_t();
+
+      worker->lane = rocksdb_native_lane_t(lane);
+      worker->executor = executor;
+
+      err = uv_thread_create(&worker->thread, rocksdb_native__executor_work, worker);
+      assert(err == 0);
+
+      executor->workers.push_back(worker);
+    }
+  }
+
+  err = js_add_deferred_teardown_callback(env, rocksdb_native__on_executor_teardown, executor, &executor->teardown);
+  assert(err == 0);
+
+  wrapper->state = executor;
 
   return handle;
 }
 
-static void
-rocksdb_native_column_family_destroy(
-  js_env_t *env,
-  js_arraybuffer_span_of_t<rocksdb_native_column_family_t, 1> column_family
-) {
-  int err;
+static void
+rocksdb_native_executor_destroy(
+  js_env_t *env,
+  js_arraybuffer_span_of_t<rocksdb_native_executor_t, 1> wrapper
+) {
+  int err;
+
+  auto executor = wrapper->state;
+
+  // Stopping now would free the executor under jobs still queued or running
+  // and drop their completions.
+  if (executor->pending > 0) {
+    err = js_throw_error(env, uv_err_name(UV_EBUSY), "Executor has pending work");
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  rocksdb_native__executor_stop(executor);
+
+  wrapper->state = nullptr;
+}
+
+static uint32_t
+rocksdb_native_executor_pending(
+  js_env_t *env,
+  js_arraybuffer_span_of_t<rocksdb_native_executor_t, 1> wrapper,
+  uint32_t lane
+) {
+  assert(lane < rocksdb_native_lane_count);
+
+  auto executor = wrapper->state;
+
+  uv_mutex_lock(&executor->lock);
+
+  auto pending = uint32_t(executor->lanes[lane].size());
+
+  uv_mutex_unlock(&executor->lock);
+
+  return pending;
+}
+
+static js_arraybuffer_t
+rocksdb_native_drop_filter_init(js_env_t *env) {
+  int err;
+
+  js_arraybuffer_t handle;
+
+  rocksdb_native_drop_filter_t *filter;
+  err = js_create_arraybuffer(env, filter, handle);
+  assert(err == 0);
+
+  err = rocksdb_drop_filter_init(&filter->handle);
+
+  if (err < 0) {
+    err = js_throw_error(env, uv_err_name(err), uv_strerror(err));
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  return handle;
+}
+
+static void
+rocksdb_native_drop_filter_update(
+  js_env_t *env,
+  js_arraybuffer_span_of_t<rocksdb_native_drop_filter_t, 1> filter,
+  js_array_t prefixes_array,
+  js_array_t starts_array,
+  js_array_t ends_array
+) {
+  int err;
+
+  std::vector<js_typedarray_t<>> prefix_elements;
+  err = js_get_array_elements(env, prefixes_array, prefix_elements);
+  assert(err == 0);
+
+  std::vector<js_typedarray_t<>> start_elements;
+  err = js_get_array_elements(env, starts_array, start_elements);
+  assert(err == 0);
+
+  std::vector<js_typedarray_t<>> end_elements;
+  err = js_get_array_elements(env, ends_array, end_elements);
+  assert(err == 0);
+
+  assert(start_elements.size() == end_elements.size());
+
+  std::vector<rocksdb_slice_t> prefixes(prefix_elements.size());
+
+  for (size_t i = 0, n = prefixes.size(); i < n; i++) {
+    err = js_get_typedarray_info(env, prefix_elements[i], prefixes[i].data, prefixes[i].len);
+    assert(err == 0);
+  }
+
+  std::vector<rocksdb_range_t> ranges(start_elements.size());
+
+  for (size_t i = 0, n = ranges.size(); i < n; i++) {
+    err = js_get_typedarray_info(env, start_elements[i], ranges[i].gte.data, ranges[i].gte.len);
+    assert(err == 0);
+
+    err = js_get_typedarray_info(env, end_elements[i], ranges[i].lt.data, ranges[i].lt.len);
+    assert(err == 0);
+  }
+
+  // The filter copies the keys into a new immutable set and swaps it in
+  // atomically, so compactions in flight keep using the previous set.
+  err = rocksdb_drop_filter_update(&filter->handle, prefixes.data(), prefixes.size(), ranges.data(), ranges.size());
+
+  if (err < 0) {
+    err = js_throw_error(env, uv_err_name(err), uv_strerror(err));
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+}
+
+static void
+rocksdb_native_drop_filter_destroy(
+  js_env_t *env,
+  js_arraybuffer_span_of_t<rocksdb_native_drop_filter_t, 1> filter
+) {
+  rocksdb_drop_filter_destroy(&filter->handle);
+}
+
+static js_arraybuffer_t
+rocksdb_native_column_family_init(
+  js_env_t *env,
+  std::string name,
+  bool enable_blob_files,
+  uint64_t min_blob_size,
+  uint64_t blob_file_size,
+  bool enable_blob_garbage_collection,
+  uint64_t block_size,
+  bool cache_index_and_filter_blocks,
+  uint32_t format_version,
+  bool optimize_filters_for_memory,
+  bool no_block_cache,
+  uint32_t filter_policy_type,
+  double bits_per_key,
+  int32_t bloom_before_level,
+  uint32_t top_level_index_pinning_tier,
+  uint32_t partition_pinning_tier,
+  uint32_t unpartitioned_pinning_tier,
+  bool optimize_filters_for_hits,
+  int32_t num_levels,
+  int32_t max_write_buffer_number,
+  double blob_garbage_collection_age_cutoff,
+  double blob_garbage_collection_force_threshold,
+  std::optional<js_arraybuffer_span_of_t<rocksdb_native_block_cache_t, 1>> block_cache,
+  uint32_t compression,
+  js_typedarray_t<uint32_t> compression_per_level,
+  uint32_t bottommost_compression,
+  int32_t compression_level,
+  uint32_t compression_max_dict_bytes,
+  uint64_t compression_zstd_max_train_bytes,
+  uint32_t blob_compression,
+  uint32_t compaction_style,
+  uint32_t universal_size_ratio,
+  uint32_t universal_max_merge_width,
+  uint64_t fifo_max_table_files_size,
+  int64_t ttl,
+  uint32_t expiry_field,
+  uint32_t expiry_width,
+  std::optional<js_arraybuffer_span_of_t<rocksdb_native_drop_filter_t, 1>> drop_filter,
+  uint64_t compact_on_deletion_window_size,
+  uint64_t compact_on_deletion_trigger,
+  double compact_on_deletion_ratio,
+  int32_t level0_file_num_compaction_trigger,
+  int32_t level0_slowdown_writes_trigger,
+  int32_t level0_stop_writes_trigger
+) {
+  int err;
+
+  uint32_t *levels;
+  size_t levels_len;
+  err = js_get_typedarray_info(env, compression_per_level, levels, levels_len);
+  assert(err == 0);
+
+  rocksdb_filter_policy_t filter_policy = {rocksdb_filter_policy_type_t(filter_policy_type)};
+
+  switch (filter_policy_type) {
+  case rocksdb_bloom_filter_policy:
+    filter_policy.bloom = (rocksdb_bloom_filter_options_t) {
+      0,
+      bits_per_key
+    };
+    break;
+
+  case rocksdb_ribbon_filter_policy:
+    filter_policy.ribbon = (rocksdb_ribbon_filter_options_t) {
+      0,
+      bits_per_key,
+      bloom_before_level,
+    };
+    break;
+  }
+
+  uv_loop_t *loop;
+  err = js_get_env_loop(env, &loop);
+  assert(err == 0);
+
+  js_arraybuffer_t handle;
+
+  rocksdb_native_column_family_t *column_family;
+  err = js_create_arraybuffer(env, column_family, handle);
+  assert(err == 0);
+
+  column_family->db = nullptr;
+  column_family->handle = nullptr;
+
+  new (&column_family->name) std::string(std::move(name));
+
+  new (&column_family->compression_per_level) std::vector<rocksdb_compression_t>();
+
+  for (size_t i = 0; i < levels_len; i++) {
+    column_family->compression_per_level.push_back(rocksdb_compression_t(levels[i]));
+  }
+
+  column_family->descriptor = (rocksdb_column_family_descriptor_t) {
+    column_family->name.c_str(),
+    {
+      12,
+      rocksdb_compaction_style_t(compaction_style),
+      enable_blob_files,
+      min_blob_size,
+      blob_file_size,
+      enable_blob_garbage_collection,
+      block_size,
+      cache_index_and_filter_blocks,
+      format_version,
+      optimize_filters_for_memory,
+      no_block_cache,
+      filter_policy,
+      rocksdb_pinning_tier_t(top_level_index_pinning_tier),
+      rocksdb_pinning_tier_t(partition_pinning_tier),
+      rocksdb_pinning_tier_t(unpartitioned_pinning_tier),
+      optimize_filters_for_hits,
+      num_levels,
+      max_write_buffer_number,
+      blob_garbage_collection_age_cutoff,
+      blob_garbage_collection_force_threshold,
+      block_cache ? &block_cache.value()->handle : nullptr,
+      rocksdb_compression_t(compression),
+      column_family->compression_per_level.data(),
+      column_family->compression_per_level.size(),
+      rocksdb_compression_t(bottommost_compression),
+      (rocksdb_compression_options_t) {
+        compression_level,
+        compression_max_dict_bytes,
+        compression_zstd_max_train_bytes,
+      },
+      rocksdb_compression_t(blob_compression),
+      universal_size_ratio,
+      universal_max_merge_width,
+      fifo_max_table_files_size,
+      // Negative selects rocksdb::kDefaultTtl, which RocksDB sanitizes per
+      // compaction style, e.g. to 30 days for level compaction
+      ttl < 0 ? 0xfffffffffffffffe : uint64_t(ttl),
+      (rocksdb_expiry_options_t) {
+        rocksdb_expiry_field_t(expiry_field),
+        expiry_width,
+      },
+      drop_filter ? &drop_filter.value()->handle : nullptr,
+      (rocksdb_compact_on_deletion_options_t) {
+        compact_on_deletion_window_size,
+        compact_on_deletion_trigger,
+        compact_on_deletion_ratio,
+      },
+      level0_file_num_compaction_trigger,
+      level0_slowdown_writes_trigger,
+      level0_stop_writes_trigger,
+    }
+  };
+
+  return handle;
+}
+
+static void
+rocksdb_native_column_family_destroy(
+  js_env_t *env,
+  js_arraybuffer_span_of_t<rocksdb_native_column_family_t, 1> column_family
+) {
+  int err;
+
+  if (column_family->handle == nullptr) return;
+
+  err = rocksdb_column_family_destroy(&column_family->db->handle, column_family->handle);
+  assert(err == 0);
+
+  column_family->db->column_families.erase(column_family);
+
+  column_family->handle = nullptr;
+
+  column_family->name.~basic_string();
+
+  column_family->compression_per_level.~vector();
+
+  column_family->ctx.reset();
+}
+
+static js_arraybuffer_t
+rocksdb_native_iterator_init(js_env_t *env) {
+  int err;
+
+  js_arraybuffer_t handle;
+
+  rocksdb_native_iterator_t *req;
+  err = js_create_arraybuffer(env, req, handle);
+  assert(err == 0);
+
+  req->env = env;
+  req->closing = false;
+  req->exiting = false;
+  req->handle.data = req;
+
+  return handle;
+}
+
+static js_arraybuffer_t
+rocksdb_native_iterator_buffer(
+  js_env_t *env,
+  js_arraybuffer_span_of_t<rocksdb_native_iterator_t, 1> req,
+  uint32_t capacity
+) {
+  int err;
+
+  js_arraybuffer_t handle;
+
+  uint8_t *data;
+  err = js_create_arraybuffer(env, 2 * capacity * sizeof(rocksdb_slice_t), data, handle);
+  assert(err == 0);
+
+  size_t offset = 0;
+
+  req->keys = reinterpret_cast<rocksdb_slice_t *>(&data[offset]);
+
+  offset += capacity * sizeof(rocksdb_slice_t);
+
+  req->values = reinterpret_cast<rocksdb_slice_t *>(&data[offset]);
+
+  return handle;
+}
+
+// RocksDB reports an expired deadline or I/O timeout as a TimedOut status and
+// a canceled manual compaction as an Incomplete status, so give those codes
+// that callers can tell apart from other I/O errors.
+static const char *
+rocksdb_native__error_code(int status, rocksdb_status_code_t code, rocksdb_status_subcode_t subcode) {
+  if (code == rocksdb_status_timed_out) return "ETIMEDOUT";
+
+  if (code == rocksdb_status_incomplete && subcode == rocksdb_status_subcode_manual_compaction_paused) return "ECANCELED";
+
+  return uv_err_name(status);
+}
+
+static void
+rocksdb_native__on_iterator_close(rocksdb_iterator_t *handle, int status) {
+  int err;
+
+  assert(status == 0);
+
+  auto req = reinterpret_cast<rocksdb_native_iterator_t *>(handle->data);
+
+  auto env = req->env;
+
+  auto teardown = req->teardown;
+
+  js_handle_scope_t *scope;
+  err = js_open_handle_scope(env, &scope);
+  assert(err == 0);
+
+  js_receiver_t ctx;
+  err = js_get_reference_value(env, req->ctx, ctx);
+  assert(err == 0);
+
+  rocksdb_native_on_iterator_close_t cb;
+  err = js_get_reference_value(env, req->on_close, cb);
+  assert(err == 0);
+
+  req->on_open.reset();
+  req->on_close.reset();
+  req->on_read.reset();
+  req->ctx.reset();
+
+  std::optional<js_object_t> error;
+
+  if (req->handle.error) {
+    err = js_create_error(env, uv_err_name(req->handle.status), req->handle.error, error.emplace());
+    assert(err == 0);
+  }
+
+  rocksdb_iterator_cleanup(&req->handle);
+
+  if (!req->exiting) {
+    err = js_call_function_with_checkpoint(env, cb, ctx, error);
+    (void) err;
+  }
+
+  err = js_close_handle_scope(env, scope);
+  assert(err == 0);
+
+  err = js_finish_deferred_teardown_callback(teardown);
+  assert(err == 0);
+}
+
+static void
+rocksdb_native__on_iterator_open(rocksdb_iterator_t *handle, int status) {
+  int err;
+
+  assert(status == 0);
+
+  auto req = reinterpret_cast<rocksdb_native_iterator_t *>(handle->data);
+
+  auto env = req->env;
+
+  js_handle_scope_t *scope;
+  err = js_open_handle_scope(env, &scope);
+  assert(err == 0);
+
+  js_receiver_t ctx;
+  err = js_get_reference_value(env, req->ctx, ctx);
+  assert(err == 0);
+
+  rocksdb_native_on_iterator_open_t cb;
+  err = js_get_reference_value(env, req->on_open, cb);
+  assert(err == 0);
+
+  std::optional<js_object_t> error;
+
+  if (req->handle.error) {
+    auto code = rocksdb_native__error_code(req->handle.status, req->handle.code, req->handle.subcode);
+
+    err = js_create_error(env, code, req->handle.error, error.emplace());
+    assert(err == 0);
+  }
+
+  rocksdb_iterator_cleanup(&req->handle);
+
+  if (!req->exiting) {
+    err = js_call_function_with_checkpoint(env, cb, ctx, error);
+    (void) err;
+  }
+
+  err = js_close_handle_scope(env, scope);
+  assert(err == 0);
+}
+
+static void
+rocksdb_native__on_iterator_teardown(js_deferred_teardown_t *teardown, void *data) {
+  int err;
+
+  auto req = reinterpret_cast<rocksdb_native_iterator_t *>(data);
+
+  req->exiting = true;
+
+  if (req->closing) return;
+
+  err = rocksdb_iterator_close(&req->handle, rocksdb_native__on_iterator_close);
+  assert(err == 0);
+}
+
+// RocksDB deadlines are absolute and measured against the wall clock of its
+// environment, whereas timeouts are passed in milliseconds relative to now.
+static uint64_t
+rocksdb_native__deadline(double timeout) {
+  int err;
+
+  if (timeout <= 0) return 0;
+
+  uv_timeval64_t now;
+  err = uv_gettimeofday(&now);
+  assert(err == 0);
+
+  return uint64_t(now.tv_sec) * 1000000 + now.tv_usec + uint64_t(timeout * 1000);
+}
+
+static void
+rocksdb_native_iterator_open(
+  js_env_t *env,
+  js_arraybuffer_span_of_t<rocksdb_native_t, 1> db,
+  js_arraybuffer_span_of_t<rocksdb_native_iterator_t, 1> req,
+  js_arraybuffer_span_of_t<rocksdb_native_column_family_t, 1> column_family,
+  js_typedarray_t<> gt,
+  js_typedarray_t<> gte,
+  js_typedarray_t<> lt,
+  js_typedarray_t<> lte,
+  bool reverse,
+  bool keys_only,
+  bool skip_expired,
+  bool perf,
+  double timeout,
+  double io_timeout,
+  std::optional<js_arraybuffer_span_of_t<rocksdb_native_snapshot_t, 1>> snapshot,
+  js_receiver_t ctx,
+  rocksdb_native_on_iterator_open_t on_open,
+  rocksdb_native_on_iterator_close_t on_close,
+  rocksdb_native_on_iterator_read_t on_read
+) {
+  int err;
+
+  rocksdb_range_t range;
+
+  err = js_get_typedarray_info(env, gt, range.gt.data, range.gt.len);
+  assert(err == 0);
+
+  err = js_get_typedarray_info(env, gte, range.gte.data, range.gte.len);
+  assert(err == 0);
+
+  err = js_get_typedarray_info(env, lt, range.lt.data, range.lt.len);
+  assert(err == 0);
+
+  err = js_get_typedarray_info(env, lte, range.lte.data, range.lte.len);
+  assert(err == 0);
+
+  rocksdb_iterator_options_t options = {
+    .version = 3,
+    .reverse = reverse,
+    .keys_only = keys_only,
+    .skip_expired = skip_expired,
+    .perf = perf,
+    .deadline = rocksdb_native__deadline(timeout),
+    .io_timeout = uint64_t(io_timeout * 1000)
+  };
+
+  req->perf = perf;
+
+  if (snapshot) options.snapshot = &snapshot.value()->handle;
+
+  err = rocksdb_iterator_open(&db->handle, &req->handle, column_family->handle, range, &options, rocksdb_native__on_iterator_open);
+
+  if (err < 0) {
+    err = js_throw_error(env, uv_err_name(err), uv_strerror(err));
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  err = js_create_reference(env, ctx, req->ctx);
+  assert(err == 0);
+
+  err = js_create_reference(env, on_open, req->on_open);
+  assert(err == 0);
+
+  err = js_create_reference(env, on_close, req->on_close);
+  assert(err == 0);
+
+  err = js_create_reference(env, on_read, req->on_read);
+  assert(err == 0);
+
+  err = js_add_deferred_teardown_callback(env, rocksdb_native__on_iterator_teardown, req, &req->teardown);
+  assert(err == 0);
+}
+
+static void
+rocksdb_native_iterator_close(js_env_t *env, js_arraybuffer_span_of_t<rocksdb_native_iterator_t, 1> req) {
+  int err;
+
+  err = rocksdb_iterator_close(&req->handle, rocksdb_native__on_iterator_close);
+
+  if (err < 0) {
+    err = js_throw_error(env, uv_err_name(err), uv_strerror(err));
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  req->closing = true;
+}
+
+static void
+rocksdb_native__on_iterator_read(rocksdb_iterator_t *handle, int status) {
+  int err;
+
+  assert(status == 0);
+
+  auto req = reinterpret_cast<rocksdb_native_iterator_t *>(handle->data);
+
+  auto db = reinterpret_cast<rocksdb_native_t *>(req->handle.req.db);
+
+  auto len = req->handle.len;
+
+  auto env = req->env;
+
+  js_handle_scope_t *scope;
+  err = js_open_handle_scope(env, &scope);
+  assert(err == 0);
+
+  js_receiver_t ctx;
+  err = js_get_reference_value(env, req->ctx, ctx);
+  assert(err == 0);
+
+  rocksdb_native_on_iterator_read_t cb;
+  err = js_get_reference_value(env, req->on_read, cb);
+  assert(err == 0);
+
+  std::optional<js_object_t> error;
+
+  js_array_t keys;
+  err = js_create_array(env, len, keys);
+  assert(err == 0);
+
+  js_array_t values;
+  err = js_create_array(env, len, values);
+  assert(err == 0);
+
+  if (req->handle.error) {
+    auto code = rocksdb_native__error_code(req->handle.status, req->handle.code, req->handle.subcode);
+
+    err = js_create_error(env, code, req->handle.error, error.emplace());
+    assert(err == 0);
+  } else {
+    for (size_t i = 0; i < len; i++) {
+      rocksdb_slice_t *key = &req->keys[i];
+      rocksdb_slice_t *value = &req->values[i];
+
+      if (req->exiting) {
+        rocksdb_slice_destroy(key);
+        rocksdb_slice_destroy(value);
+      } else {
+        js_arraybuffer_t result;
+
+        err = rocksdb_native__try_create_external_arraybuffer(env, const_cast<char *>(key->data), key->len, result);
+        assert(err == 0);
+
+        err = js_set_element(env, keys, i, result);
+        assert(err == 0);
+
+        err = rocksdb_native__try_create_external_arraybuffer(env, const_cast<char *>(value->data), value->len, result);
+        assert(err == 0);
+
+        err = js_set_element(env, values, i, result);
+        assert(err == 0);
+      }
+    }
+  }
+
+  rocksdb_native__record_latency(db, rocksdb_native_op_iterator_read, req->submitted, req->handle.req.started);
+
+  std::optional<js_arraybuffer_t> perf;
+
+  if (req->perf && !req->exiting) rocksdb_native__create_perf_context(env, &req->handle.perf, perf);
+
+  rocksdb_iterator_cleanup(&req->handle);
+
+  if (!req->exiting) {
+    err = js_call_function_with_checkpoint(env, cb, ctx, error, keys, values, perf);
+    (void) err;
+  }
+
+  err = js_close_handle_scope(env, scope);
+  assert(err == 0);
+}
+
+static void
+rocksdb_native_iterator_read(
+  js_env_t *env,
+  js_arraybuffer_span_of_t<rocksdb_native_iterator_t, 1> req,
+  uint32_t capacity
+) {
+  int err;
+
+  req->submitted = uv_hrtime();
+
+  err = rocksdb_iterator_read(&req->handle, req->keys, req->values, capacity, rocksdb_native__on_iterator_read);
+
+  if (err < 0) {
+    err = js_throw_error(env, uv_err_name(err), uv_strerror(err));
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+}
+
+static js_arraybuffer_t
+rocksdb_native_read_init(js_env_t *env) {
+  int err;
+
+  js_arraybuffer_t handle;
+
+  rocksdb_native_read_batch_t *req;
+  err = js_create_arraybuffer(env, req, handle);
+  assert(err == 0);
+
+  req->env = env;
+  req->handle.data = req;
+
+  return handle;
+}
+
+static js_arraybuffer_t
+rocksdb_native_read_buffer(
+  js_env_t *env,
+  js_arraybuffer_span_of_t<rocksdb_native_read_batch_t, 1> req,
+  uint32_t capacity
+) {
+  int err;
+
+  js_arraybuffer_t handle;
+
+  rocksdb_read_t *reads;
+  err = js_create_arraybuffer(env, capacity, reads, handle);
+  assert(err == 0);
+
+  req->capacity = capacity;
+  req->reads = reads;
+
+  return handle;
+}
+
+static void
+rocksdb_native__create_value(js_env_t *env, rocksdb_slice_t *value, js_arraybuffer_t &result) {
+  int err;
+
+  if (value->data == nullptr && value->len == size_t(-1)) {
+    err = js_get_null(env, static_cast<js_value_t **>(result));
+    assert(err == 0);
+  } else {
+    err = rocksdb_native__try_create_external_arraybuffer(env, const_cast<char *>(value->data), value->len, result);
+    assert(err == 0);
+  }
+}
+
+static void
+rocksdb_native__on_completions(uv_check_t *handle) {
+  int err;
+
+  auto completions = reinterpret_cast<rocksdb_native_completions_t *>(handle->data);
+
+  auto db = completions->db;
+
+  auto env = db->env;
+
+  std::vector<rocksdb_native_completion_t> queue;
+
+  queue.swap(completions->queue);
+
+  err = uv_check_stop(handle);
+  assert(err == 0);
+
+  js_handle_scope_t *scope;
+  err = js_open_handle_scope(env, &scope);
+  assert(err == 0);
+
+  js_receiver_t ctx;
+  err = js_get_reference_value(env, db->ctx, ctx);
+  assert(err == 0);
+
+  rocksdb_native_on_complete_t cb;
+  err = js_get_reference_value(env, db->on_complete, cb);
+  assert(err == 0);
+
+  js_arraybuffer_t ids_handle;
+
+  uint32_t *ids;
+  err = js_create_arraybuffer(env, queue.size(), ids, ids_handle);
+  assert(err == 0);
+
+  js_array_t results;
+  err = js_create_array(env, queue.size(), results);
+  assert(err == 0);
+
+  for (size_t i = 0, n = queue.size(); i < n; i++) {
+    auto &completion = queue[i];
+
+    ids[i] = completion.id;
+
+    if (completion.type == rocksdb_native_completion_write) continue;
+
+    auto req = reinterpret_cast<rocksdb_native_read_batch_t *>(completion.req);
+
+    auto len = req->handle.len;
+
+    js_array_t values;
+    err = js_create_array(env, len, values);
+    assert(err == 0);
+
+    for (size_t j = 0; j < len; j++) {
+      rocksdb_slice_t *value = &req->reads[j].value;
+
+      if (db->exiting) rocksdb_slice_destroy(value);
+      else {
+        js_arraybuffer_t result;
+        rocksdb_native__create_value(env, value, result);
+
+        err = js_set_element(env, values, j, result);
+        assert(err == 0);
+      }
+    }
+
+    rocksdb_read_cleanup(&req->handle);
+
+    err = js_set_element(env, results, i, values);
+    assert(err == 0);
+  }
+
+  if (!db->exiting) {
+    err = js_call_function_with_checkpoint(env, cb, ctx, ids_handle, results);
+    (void) err;
+  }
+
+  err = js_close_handle_scope(env, scope);
+  assert(err == 0);
+}
+
+static void
+rocksdb_native__queue_completion(rocksdb_native_t *db, rocksdb_native_completion_type_t type, uint32_t id, void *req) {
+  int err;
+
+  auto completions = db->completions;
+
+  if (completions->queue.empty()) {
+    err = uv_check_start(&completions->check, rocksdb_native__on_completions);
+    assert(err == 0);
+  }
+
+  completions->queue.push_back({type, id, req});
+}
+
+static bool
+rocksdb_native__read_failed(rocksdb_native_read_batch_t *req) {
+  for (size_t i = 0, n = req->handle.len; i < n; i++) {
+    if (req->handle.errors[i]) return true;
+  }
+
+  return false;
+}
+
+static void
+rocksdb_native__on_read(rocksdb_read_batch_t *handle, int status) {
+  int err;
+
+  assert(status == 0);
+
+  auto req = reinterpret_cast<rocksdb_native_read_batch_t *>(handle->data);
+
+  auto db = reinterpret_cast<rocksdb_native_t *>(req->handle.req.db);
+
+  auto len = req->handle.len;
+
+  auto env = req->env;
+
+  rocksdb_native__record_latency(db, rocksdb_native_op_read, req->submitted, req->handle.req.started);
+
+  // Requests that failed or collected a perf context take the direct path as
+  // they carry more than values.
+  if (req->id != 0 && db->completions && !db->exiting && !req->perf && !rocksdb_native__read_failed(req)) {
+    req->on_read.reset();
+    req->ctx.reset();
+
+    return rocksdb_native__queue_completion(db, rocksdb_native_completion_read, req->id, req);
+  }
+
+  js_handle_scope_t *scope;
+  err = js_open_handle_scope(env, &scope);
+  assert(err == 0);
+
+  js_receiver_t ctx;
+  err = js_get_reference_value(env, req->ctx, ctx);
+  assert(err == 0);
+
+  rocksdb_native_on_read_t cb;
+  err = js_get_reference_value(env, req->on_read, cb);
+  assert(err == 0);
+
+  req->on_read.reset();
+  req->ctx.reset();
+
+  js_array_t errors;
+  err = js_create_array(env, len, errors);
+  assert(err == 0);
+
+  js_array_t values;
+  err = js_create_array(env, len, values);
+  assert(err == 0);
+
+  for (size_t i = 0; i < len; i++) {
+    char *error = req->handle.errors[i];
+    int status = req->handle.statuses[i];
+
+    if (error) {
+      js_object_t result;
+
+      auto code = rocksdb_native__error_code(status, req->handle.codes[i], req->handle.subcodes[i]);
+
+      err = js_create_error(env, code, error, result);
+      assert(err == 0);
+
+      err = js_set_element(env, errors, i, result);
+      assert(err == 0);
+    } else {
+      rocksdb_slice_t *value = &req->reads[i].value;
+
+      if (db->exiting) rocksdb_slice_destroy(value);
+      else {
+        js_arraybuffer_t result;
+        rocksdb_native__create_value(env, value, result);
+
+        err = js_set_element(env, values, i, result);
+        assert(err == 0);
+      }
+    }
+  }
+
+  std::optional<js_arraybuffer_t> perf;
+
+  if (req->perf && !db->exiting) rocksdb_native__create_perf_context(env, &req->handle.perf, perf);
+
+  rocksdb_read_cleanup(&req->handle);
+
+  if (!db->exiting) {
+    err = js_call_function_with_checkpoint(env, cb, ctx, errors, values, perf);
+    (void) err;
+  }
+
+  err = js_close_handle_scope(env, scope);
+  assert(err == 0);
+}
+
+static void
+rocksdb_native_read(
+  js_env_t *env,
+  js_arraybuffer_span_of_t<rocksdb_native_t, 1> db,
+  js_arraybuffer_span_of_t<rocksdb_native_read_batch_t, 1> req,
+  js_array_t operations,
+  std::optional<js_arraybuffer_span_of_t<rocksdb_native_snapshot_t, 1>> snapshot,
+  bool async_io,
+  bool fill_cache,
+  bool row_cache,
+  bool skip_expired,
+  bool perf,
+  double timeout,
+  double io_timeout,
+  uint32_t id,
+  js_receiver_t ctx,
+  rocksdb_native_on_read_t on_read
+) {
+  int err;
+
+  std::vector<js_object_t> elements;
+  err = js_get_array_elements(env, operations, elements);
+  assert(err == 0);
+
+  const auto len = elements.size();
+
+  for (uint32_t i = 0; i < len; i++) {
+    js_object_t read = elements[i];
+
+    rocksdb_read_type_t type;
+    err = js_get_property(env, read, "type", reinterpret_cast<uint32_t &>(type));
+    assert(err == 0);
+
+    req->reads[i].type = type;
+
+    js_arraybuffer_t column_family_property;
+    err = js_get_property(env, read, "columnFamily", column_family_property);
+    assert(err == 0);
+
+    rocksdb_native_column_family_t *column_family;
+    err = js_get_arraybuffer_info(env, column_family_property, column_family);
+    assert(err == 0);
+
+    req->reads[i].column_family = column_family->handle;
+
+    switch (type) {
+    case rocksdb_get: {
+      js_typedarray_t property;
+
+      rocksdb_slice_t *key = &req->reads[i].key;
+
+      err = js_get_property(env, read, "key", property);
+      assert(err == 0);
+
+      err = js_get_typedarray_info(env, property, key->data, key->len);
+      assert(err == 0);
+      break;
+    }
+    }
+  }
+
+  rocksdb_read_options_t options = {
+    .version = 5,
+    .async_io = async_io,
+    .fill_cache = fill_cache,
+    .skip_row_cache = !row_cache,
+    .skip_expired = skip_expired,
+    .perf = perf,
+    .deadline = rocksdb_native__deadline(timeout),
+    .io_timeout = uint64_t(io_timeout * 1000)
+  };
+
+  req->perf = perf;
+  req->id = id;
+
+  if (snapshot) options.snapshot = &snapshot.value()->handle;
 
-  if (column_family->handle == nullptr) return;
+  req->submitted = uv_hrtime();
 
-  err = rocksdb_column_family_destroy(&column_family->db->handle, column_family->handle);
-  assert(err == 0);
+  err = rocksdb_read(&db->handle, &req->handle, req->reads, len, &options, rocksdb_native__on_read);
 
-  column_family->db->column_families.erase(column_family);
+  if (err < 0) {
+    err = js_throw_error(env, uv_err_name(err), uv_strerror(err));
+    assert(err == 0);
 
-  column_family->handle = nullptr;
+    throw js_pending_exception;
+  }
 
-  column_family->name.~basic_string();
+  err = js_create_reference(env, ctx, req->ctx);
+  assert(err == 0);
 
-  column_family->ctx.reset();
+  err = js_create_reference(env, on_read, req->on_read);
+  assert(err == 0);
 }
 
 static js_arraybuffer_t
-rocksdb_native_iterator_init(js_env_t *env) {
+rocksdb_native_write_init(js_env_t *env) {
   int err;
 
   js_arraybuffer_t handle;
 
-  rocksdb_native_iterator_t *req;
+  rocksdb_native_write_batch_t *req;
   err = js_create_arraybuffer(env, req, handle);
   assert(err == 0);
 
   req->env = env;
-  req->closing = false;
-  req->exiting = false;
   req->handle.data = req;
 
   return handle;
 }
 
 static js_arraybuffer_t
-rocksdb_native_iterator_buffer(
+rocksdb_native_write_buffer(
   js_env_t *env,
-  js_arraybuffer_span_of_t<rocksdb_native_iterator_t, 1> req,
+  js_arraybuffer_span_of_t<rocksdb_native_write_batch_t, 1> req,
   uint32_t capacity
 ) {
   int err;
 
   js_arraybuffer_t handle;
 
-  uint8_t *data;
-  err = js_create_arraybuffer(env, 2 * capacity * sizeof(rocksdb_slice_t), data, handle);
+  rocksdb_write_t *writes;
+  err = js_create_arraybuffer(env, capacity, writes, handle);
   assert(err == 0);
 
-  size_t offset = 0;
-
-  req->keys = reinterpret_cast<rocksdb_slice_t *>(&data[offset]);
-
-  offset += capacity * sizeof(rocksdb_slice_t);
-
-  req->values = reinterpret_cast<rocksdb_slice_t *>(&data[offset]);
+  req->capacity = capacity;
+  req->writes = writes;
 
   return handle;
 }
 
 static void
-rocksdb_native__on_iterator_close(rocksdb_iterator_t *handle, int status) {
+rocksdb_native__on_write(rocksdb_write_batch_t *handle, int status) {
   int err;
 
   assert(status == 0);
 
-  auto req = reinterpret_cast<rocksdb_native_iterator_t *>(handle->data);
+  auto req = reinterpret_cast<rocksdb_native_write_batch_t *>(handle->data);
+
+  auto db = reinterpret_cast<rocksdb_native_t *>(req->handle.req.db);
 
   auto env = req->env;
 
-  auto teardown = req->teardown;
+  rocksdb_native__record_latency(db, rocksdb_native_op_write, req->submitted, req->handle.req.started);
+
+  if (req->id != 0 && db->completions && !db->exiting && !req->perf && !req->handle.error) {
+    req->on_write.reset();
+    req->ctx.reset();
+
+    rocksdb_write_cleanup(&req->handle);
+
+    return rocksdb_native__queue_completion(db, rocksdb_native_completion_write, req->id, req);
+  }
 
   js_handle_scope_t *scope;
   err = js_open_handle_scope(env, &scope);
@@ -940,133 +2992,147 @@ rocksdb_native__on_iterator_close(rocksdb_iterator_t *handle, int status) {
   err = js_get_reference_value(env, req->ctx, ctx);
   assert(err == 0);
 
-  rocksdb_native_on_iterator_close_t cb;
-  err = js_get_reference_value(env, req->on_close, cb);
+  rocksdb_native_on_write_t cb;
+  err = js_get_reference_value(env, req->on_write, cb);
   assert(err == 0);
 
-  req->on_open.reset();
-  req->on_close.reset();
-  req->on_read.reset();
+  req->on_write.reset();
   req->ctx.reset();
 
   std::optional<js_object_t> error;
 
   if (req->handle.error) {
-    err = js_create_error(env, uv_err_name(req->handle.status), req->handle.error, error.emplace());
+    auto code = uv_err_name(req->handle.status);
+
+    // RocksDB refuses a no_slowdown write under a stall with an Incomplete
+    // status, so give it the same code as the writes refused in JavaScript
+    // before being submitted.
+    if (req->no_slowdown && req->handle.code == rocksdb_status_incomplete) code = "EAGAIN";
+
+    err = js_create_error(env, code, req->handle.error, error.emplace());
     assert(err == 0);
   }
 
-  rocksdb_iterator_cleanup(&req->handle);
+  std::optional<js_arraybuffer_t> perf;
 
-  if (!req->exiting) {
-    err = js_call_function_with_checkpoint(env, cb, ctx, error);
+  if (req->perf && !db->exiting) rocksdb_native__create_perf_context(env, &req->handle.perf, perf);
+
+  rocksdb_write_cleanup(&req->handle);
+
+  if (!db->exiting) {
+    err = js_call_function_with_checkpoint(env, cb, ctx, error, perf);
     (void) err;
   }
 
   err = js_close_handle_scope(env, scope);
   assert(err == 0);
-
-  err = js_finish_deferred_teardown_callback(teardown);
-  assert(err == 0);
 }
 
 static void
-rocksdb_native__on_iterator_open(rocksdb_iterator_t *handle, int status) {
+rocksdb_native_write(
+  js_env_t *env,
+  js_arraybuffer_span_of_t<rocksdb_native_t, 1> db,
+  js_arraybuffer_span_of_t<rocksdb_native_write_batch_t, 1> req,
+  js_array_t operations,
+  bool perf,
+  bool no_slowdown,
+  uint32_t id,
+  js_receiver_t ctx,
+  rocksdb_native_on_write_t on_write
+) {
   int err;
 
-  assert(status == 0);
-
-  auto req = reinterpret_cast<rocksdb_native_iterator_t *>(handle->data);
+  std::vector<js_object_t> elements;
+  err = js_get_array_elements(env, operations, elements);
+  assert(err == 0);
 
-  auto env = req->env;
+  const auto len = elements.size();
 
-  js_handle_scope_t *scope;
-  err = js_open_handle_scope(env, &scope);
-  assert(err == 0);
+  for (uint32_t i = 0; i < len; i++) {
+    js_object_t write = elements[i];
 
-  js_receiver_t ctx;
-  err = js_get_reference_value(env, req->ctx, ctx);
-  assert(err == 0);
+    rocksdb_write_type_t type;
+    err = js_get_property(env, write, "type", reinterpret_cast<uint32_t &>(type));
+    assert(err == 0);
 
-  rocksdb_native_on_iterator_open_t cb;
-  err = js_get_reference_value(env, req->on_open, cb);
-  assert(err == 0);
+    req->writes[i].type = type;
 
-  std::optional<js_object_t> error;
+    js_arraybuffer_t column_family_property;
+    err = js_get_property(env, write, "columnFamily", column_family_property);
+    assert(err == 0);
 
-  if (req->handle.error) {
-    err = js_create_error(env, uv_err_name(req->handle.status), req->handle.error, error.emplace());
+    rocksdb_native_column_family_t *column_family;
+    err = js_get_arraybuffer_info(env, column_family_property, column_family);
     assert(err == 0);
-  }
 
-  rocksdb_iterator_cleanup(&req->handle);
+    req->writes[i].column_family = column_family->handle;
 
-  if (!req->exiting) {
-    err = js_call_function_with_checkpoint(env, cb, ctx, error);
-    (void) err;
-  }
+    js_typedarray_t property;
 
-  err = js_close_handle_scope(env, scope);
-  assert(err == 0);
-}
+    switch (type) {
+    case rocksdb_put: {
+      rocksdb_slice_t *key = &req->writes[i].key;
 
-static void
-rocksdb_native__on_iterator_teardown(js_deferred_teardown_t *teardown, void *data) {
-  int err;
+      err = js_get_property(env, write, "key", property);
+      assert(err == 0);
 
-  auto req = reinterpret_cast<rocksdb_native_iterator_t *>(data);
+      err = js_get_typedarray_info(env, property, key->data, key->len);
+      assert(err == 0);
 
-  req->exiting = true;
+      rocksdb_slice_t *value = &req->writes[i].value;
 
-  if (req->closing) return;
+      err = js_get_property(env, write, "value", property);
+      assert(err == 0);
 
-  err = rocksdb_iterator_close(&req->handle, rocksdb_native__on_iterator_close);
-  assert(err == 0);
-}
+      err = js_get_typedarray_info(env, property, value->data, value->len);
+      assert(err == 0);
+      break;
+    }
 
-static void
-rocksdb_native_iterator_open(
-  js_env_t *env,
-  js_arraybuffer_span_of_t<rocksdb_native_t, 1> db,
-  js_arraybuffer_span_of_t<rocksdb_native_iterator_t, 1> req,
-  js_arraybuffer_span_of_t<rocksdb_native_column_family_t, 1> column_family,
-  js_typedarray_t<> gt,
-  js_typedarray_t<> gte,
-  js_typedarray_t<> lt,
-  js_typedarray_t<> lte,
-  bool reverse,
-  bool keys_only,
-  std::optional<js_arraybuffer_span_of_t<rocksdb_native_snapshot_t, 1>> snapshot,
-  js_receiver_t ctx,
-  rocksdb_native_on_iterator_open_t on_open,
-  rocksdb_native_on_iterator_close_t on_close,
-  rocksdb_native_on_iterator_read_t on_read
-) {
-  int err;
+    case rocksdb_delete: {
+      rocksdb_slice_t *key = &req->writes[i].key;
 
-  rocksdb_range_t range;
+      err = js_get_property(env, write, "key", property);
+      assert(err == 0);
 
-  err = js_get_typedarray_info(env, gt, range.gt.data, range.gt.len);
-  assert(err == 0);
+      err = js_get_typedarray_info(env, property, key->data, key->len);
+      assert(err == 0);
+      break;
+    }
 
-  err = js_get_typedarray_info(env, gte, range.gte.data, range.gte.len);
-  assert(err == 0);
+    case rocksdb_delete_range: {
+      rocksdb_slice_t *start = &req->writes[i].start;
 
-  err = js_get_typedarray_info(env, lt, range.lt.data, range.lt.len);
-  assert(err == 0);
+      err = js_get_property(env, write, "start", property);
+      assert(err == 0);
 
-  err = js_get_typedarray_info(env, lte, range.lte.data, range.lte.len);
-  assert(err == 0);
+      err = js_get_typedarray_info(env, property, start->data, start->len);
+      assert(err == 0);
 
-  rocksdb_iterator_options_t options = {
-    .version = 0,
-    .reverse = reverse,
-    .keys_only = keys_only
+      rocksdb_slice_t *end = &req->writes[i].end;
+
+      err = js_get_property(env, write, "end", property);
+      assert(err == 0);
+
+      err = js_get_typedarray_info(env, property, end->data, end->len);
+      assert(err == 0);
+      break;
+    }
+    }
+  }
+
+  rocksdb_write_options_t options = {
+    .version = 2,
+    .perf = perf,
+    .no_slowdown = no_slowdown
   };
 
-  if (snapshot) options.snapshot = &snapshot.value()->handle;
+  req->perf = perf;
+  req->no_slowdown = no_slowdown;
+  req->id = id;
+  req->submitted = uv_hrtime();
 
-  err = rocksdb_iterator_open(&db->handle, &req->handle, column_family->handle, range, &options, rocksdb_native__on_iterator_open);
+  err = rocksdb_write(&db->handle, &req->handle, req->writes, len, &options, rocksdb_native__on_write);
 
   if (err < 0) {
     err = js_throw_error(env, uv_err_name(err), uv_strerror(err));
@@ -1078,47 +3144,20 @@ rocksdb_native_iterator_open(
   err = js_create_reference(env, ctx, req->ctx);
   assert(err == 0);
 
-  err = js_create_reference(env, on_open, req->on_open);
-  assert(err == 0);
-
-  err = js_create_reference(env, on_close, req->on_close);
-  assert(err == 0);
-
-  err = js_create_reference(env, on_read, req->on_read);
-  assert(err == 0);
-
-  err = js_add_deferred_teardown_callback(env, rocksdb_native__on_iterator_teardown, req, &req->teardown);
+  err = js_create_reference(env, on_write, req->on_write);
   assert(err == 0);
 }
 
 static void
-rocksdb_native_iterator_close(js_env_t *env, js_arraybuffer_span_of_t<rocksdb_native_iterator_t, 1> req) {
-  int err;
-
-  err = rocksdb_iterator_close(&req->handle, rocksdb_native__on_iterator_close);
-
-  if (err < 0) {
-    err = js_throw_error(env, uv_err_name(err), uv_strerror(err));
-    assert(err == 0);
-
-    throw js_pending_exception;
-  }
-
-  req->closing = true;
-}
-
-static void
-rocksdb_native__on_iterator_read(rocksdb_iterator_t *handle, int status) {
+rocksdb_native__on_flush(rocksdb_flush_t *handle, int status) {
   int err;
 
   assert(status == 0);
 
-  auto req = reinterpret_cast<rocksdb_native_iterator_t *>(handle->data);
+  auto req = reinterpret_cast<rocksdb_native_flush_t *>(handle->data);
 
   auto db = reinterpret_cast<rocksdb_native_t *>(req->handle.req.db);
 
-  auto len = req->handle.len;
-
   auto env = req->env;
 
   js_handle_scope_t *scope;
@@ -1129,53 +3168,26 @@ rocksdb_native__on_iterator_read(rocksdb_iterator_t *handle, int status) {
   err = js_get_reference_value(env, req->ctx, ctx);
   assert(err == 0);
 
-  rocksdb_native_on_iterator_read_t cb;
-  err = js_get_reference_value(env, req->on_read, cb);
-  assert(err == 0);
-
-  std::optional<js_object_t> error;
-
-  js_array_t keys;
-  err = js_create_array(env, len, keys);
+  rocksdb_native_on_flush_t cb;
+  err = js_get_reference_value(env, req->on_flush, cb);
   assert(err == 0);
 
-  js_array_t values;
-  err = js_create_array(env, len, values);
-  assert(err == 0);
+  req->on_flush.reset();
+  req->ctx.reset();
+
+  std::optional<js_object_t> error;
 
   if (req->handle.error) {
     err = js_create_error(env, uv_err_name(req->handle.status), req->handle.error, error.emplace());
     assert(err == 0);
-  } else {
-    for (size_t i = 0; i < len; i++) {
-      rocksdb_slice_t *key = &req->keys[i];
-      rocksdb_slice_t *value = &req->values[i];
-
-      if (req->exiting) {
-        rocksdb_slice_destroy(key);
-        rocksdb_slice_destroy(value);
-      } else {
-        js_arraybuffer_t result;
-
-        err = rocksdb_native__try_create_external_arraybuffer(env, const_cast<char *>(key->data), key->len, result);
-        assert(err == 0);
-
-        err = js_set_element(env, keys, i, result);
-        assert(err == 0);
-
-        err = rocksdb_native__try_create_external_arraybuffer(env, const_cast<char *>(value->data), value->len, result);
-        assert(err == 0);
-
-        err = js_set_element(env, values, i, result);
-        assert(err == 0);
-      }
-    }
   }
 
-  rocksdb_iterator_cleanup(&req->handle);
+  rocksdb_native__record_latency(db, rocksdb_native_op_flush, req->submitted, req->handle.req.started);
 
-  if (!req->exiting) {
-    err = js_call_function_with_checkpoint(env, cb, ctx, error, keys, values);
+  rocksdb_flush_cleanup(&req->handle);
+
+  if (!db->exiting) {
+    err = js_call_function_with_checkpoint(env, cb, ctx, error);
     (void) err;
   }
 
@@ -1183,72 +3195,55 @@ rocksdb_native__on_iterator_read(rocksdb_iterator_t *handle, int status) {
   assert(err == 0);
 }
 
-static void
-rocksdb_native_iterator_read(
+static js_arraybuffer_t
+rocksdb_native_flush(
   js_env_t *env,
-  js_arraybuffer_span_of_t<rocksdb_native_iterator_t, 1> req,
-  uint32_t capacity
+  js_arraybuffer_span_of_t<rocksdb_native_t, 1> db,
+  js_arraybuffer_span_of_t<rocksdb_native_column_family_t, 1> column_family,
+  js_receiver_t ctx,
+  rocksdb_native_on_flush_t on_flush
 ) {
   int err;
 
-  err = rocksdb_iterator_read(&req->handle, req->keys, req->values, capacity, rocksdb_native__on_iterator_read);
-
-  if (err < 0) {
-    err = js_throw_error(env, uv_err_name(err), uv_strerror(err));
-    assert(err == 0);
-
-    throw js_pending_exception;
-  }
-}
-
-static js_arraybuffer_t
-rocksdb_native_read_init(js_env_t *env) {
-  int err;
-
   js_arraybuffer_t handle;
 
-  rocksdb_native_read_batch_t *req;
+  rocksdb_native_flush_t *req;
   err = js_create_arraybuffer(env, req, handle);
   assert(err == 0);
 
   req->env = env;
   req->handle.data = req;
 
-  return handle;
-}
+  req->submitted = uv_hrtime();
 
-static js_arraybuffer_t
-rocksdb_native_read_buffer(
-  js_env_t *env,
-  js_arraybuffer_span_of_t<rocksdb_native_read_batch_t, 1> req,
-  uint32_t capacity
-) {
-  int err;
+  err = rocksdb_flush(&db->handle, &req->handle, column_family->handle, nullptr, rocksdb_native__on_flush);
 
-  js_arraybuffer_t handle;
+  if (err < 0) {
+    err = js_throw_error(env, uv_err_name(err), uv_strerror(err));
+    assert(err == 0);
 
-  rocksdb_read_t *reads;
-  err = js_create_arraybuffer(env, capacity, reads, handle);
+    throw js_pending_exception;
+  }
+
+  err = js_create_reference(env, ctx, req->ctx);
   assert(err == 0);
 
-  req->capacity = capacity;
-  req->reads = reads;
+  err = js_create_reference(env, on_flush, req->on_flush);
+  assert(err == 0);
 
   return handle;
 }
 
 static void
-rocksdb_native__on_read(rocksdb_read_batch_t *handle, int status) {
+rocksdb_native__on_compact_range(rocksdb_compact_range_t *handle, int status) {
   int err;
 
   assert(status == 0);
 
-  auto req = reinterpret_cast<rocksdb_native_read_batch_t *>(handle->data);
+  auto req = reinterpret_cast<rocksdb_native_compact_range_t *>(handle->data);
 
   auto db = reinterpret_cast<rocksdb_native_t *>(req->handle.req.db);
 
-  auto len = req->handle.len;
-
   auto env = req->env;
 
   js_handle_scope_t *scope;
@@ -1259,58 +3254,28 @@ rocksdb_native__on_read(rocksdb_read_batch_t *handle, int status) {
   err = js_get_reference_value(env, req->ctx, ctx);
   assert(err == 0);
 
-  rocksdb_native_on_read_t cb;
-  err = js_get_reference_value(env, req->on_read, cb);
+  rocksdb_native_on_compact_range_t cb;
+  err = js_get_reference_value(env, req->on_compact_range, cb);
   assert(err == 0);
 
-  req->on_read.reset();
+  req->on_compact_range.reset();
   req->ctx.reset();
 
-  js_array_t errors;
-  err = js_create_array(env, len, errors);
-  assert(err == 0);
-
-  js_array_t values;
-  err = js_create_array(env, len, values);
-  assert(err == 0);
-
-  for (size_t i = 0; i < len; i++) {
-    char *error = req->handle.errors[i];
-    int status = req->handle.statuses[i];
-
-    if (error) {
-      js_object_t result;
-
-      err = js_create_error(env, uv_err_name(status), error, result);
-      assert(err == 0);
-
-      err = js_set_element(env, errors, i, result);
-      assert(err == 0);
-    } else {
-      rocksdb_slice_t *value = &req->reads[i].value;
-
-      if (db->exiting) rocksdb_slice_destroy(value);
-      else {
-        js_arraybuffer_t result;
+  std::optional<js_object_t> error;
 
-        if (value->data == nullptr && value->len == size_t(-1)) {
-          err = js_get_null(env, static_cast<js_value_t **>(result));
-          assert(err == 0);
-        } else {
-          err = rocksdb_native__try_create_external_arraybuffer(env, const_cast<char *>(value->data), value->len, result);
-          assert(err == 0);
-        }
+  if (req->handle.error) {
+    auto code = rocksdb_native__error_code(req->handle.status, req->handle.code, req->handle.subcode);
 
-        err = js_set_element(env, values, i, result);
-        assert(err == 0);
-      }
-    }
+    err = js_create_error(env, code, req->handle.error, error.emplace());
+    assert(err == 0);
   }
 
-  rocksdb_read_cleanup(&req->handle);
+  rocksdb_native__record_latency(db, rocksdb_native_op_compact, req->submitted, req->handle.req.started);
+
+  rocksdb_compact_range_cleanup(&req->handle);
 
   if (!db->exiting) {
-    err = js_call_function_with_checkpoint(env, cb, ctx, errors, values);
+    err = js_call_function_with_checkpoint(env, cb, ctx, error);
     (void) err;
   }
 
@@ -1318,128 +3283,188 @@ rocksdb_native__on_read(rocksdb_read_batch_t *handle, int status) {
   assert(err == 0);
 }
 
-static void
-rocksdb_native_read(
+static js_arraybuffer_t
+rocksdb_native_compact_range(
   js_env_t *env,
   js_arraybuffer_span_of_t<rocksdb_native_t, 1> db,
-  js_arraybuffer_span_of_t<rocksdb_native_read_batch_t, 1> req,
-  js_array_t operations,
-  std::optional<js_arraybuffer_span_of_t<rocksdb_native_snapshot_t, 1>> snapshot,
-  bool async_io,
-  bool fill_cache,
+  js_arraybuffer_span_of_t<rocksdb_native_column_family_t, 1> column_family,
+  js_typedarray_t<> start,
+  js_typedarray_t<> end,
+  bool exclusive,
+  uint32_t blob_garbage_collection_policy,
+  double blob_garbage_collection_age_cutoff,
+  uint32_t bottommost_level_compaction,
   js_receiver_t ctx,
-  rocksdb_native_on_read_t on_read
+  rocksdb_native_on_compact_range_t on_compact_range
 ) {
   int err;
 
-  std::vector<js_object_t> elements;
-  err = js_get_array_elements(env, operations, elements);
+  rocksdb_slice_t start_slice;
+  err = js_get_typedarray_info(env, start, start_slice.data, start_slice.len);
   assert(err == 0);
 
-  const auto len = elements.size();
+  rocksdb_slice_t end_slice;
+  err = js_get_typedarray_info(env, end, end_slice.data, end_slice.len);
+  assert(err == 0);
 
-  for (uint32_t i = 0; i < len; i++) {
-    js_object_t read = elements[i];
+  js_arraybuffer_t handle;
 
-    rocksdb_read_type_t type;
-    err = js_get_property(env, read, "type", reinterpret_cast<uint32_t &>(type));
-    assert(err == 0);
+  rocksdb_native_compact_range_t *req;
+  err = js_create_arraybuffer(env, req, handle);
+  assert(err == 0);
 
-    req->reads[i].type = type;
+  req->env = env;
+  req->handle.data = req;
 
-    js_arraybuffer_t column_family_property;
-    err = js_get_property(env, read, "columnFamily", column_family_property);
-    assert(err == 0);
+  rocksdb_compact_range_options_t options;
+  rocksdb_compact_range_options_init(&options, 2);
 
-    rocksdb_native_column_family_t *column_family;
-    err = js_get_arraybuffer_info(env, column_family_property, column_family);
+  options.exclusive_manual_compaction = exclusive;
+  options.blob_garbage_collection_policy = rocksdb_blob_garbage_collection_policy_t(blob_garbage_collection_policy);
+  options.blob_garbage_collection_age_cutoff = blob_garbage_collection_age_cutoff;
+  options.bottommost_level_compaction = rocksdb_bottommost_level_compaction_t(bottommost_level_compaction);
+  options.canceled = &req->canceled;
+
+  req->submitted = uv_hrtime();
+
+  err = rocksdb_compact_range(&db->handle, &req->handle, column_family->handle, start_slice, end_slice, &options, rocksdb_native__on_compact_range);
+
+  if (err < 0) {
+    err = js_throw_error(env, uv_err_name(err), uv_strerror(err));
     assert(err == 0);
 
-    req->reads[i].column_family = column_family->handle;
+    throw js_pending_exception;
+  }
 
-    switch (type) {
-    case rocksdb_get: {
-      js_typedarray_t property;
+  err = js_create_reference(env, ctx, req->ctx);
+  assert(err == 0);
 
-      rocksdb_slice_t *key = &req->reads[i].key;
+  err = js_create_reference(env, on_compact_range, req->on_compact_range);
+  assert(err == 0);
 
-      err = js_get_property(env, read, "key", property);
-      assert(err == 0);
+  return handle;
+}
 
-      err = js_get_typedarray_info(env, property, key->data, key->len);
-      assert(err == 0);
-      break;
-    }
-    }
-  }
+static void
+rocksdb_native__on_compact(rocksdb_compact_t *handle, int status) {
+  int err;
 
-  rocksdb_read_options_t options = {
-    .version = 1,
-    .async_io = async_io,
-    .fill_cache = fill_cache
-  };
+  assert(status == 0);
 
-  if (snapshot) options.snapshot = &snapshot.value()->handle;
+  auto req = reinterpret_cast<rocksdb_native_compact_t *>(handle->data);
 
-  err = rocksdb_read(&db->handle, &req->handle, req->reads, len, &options, rocksdb_native__on_read);
+  auto db = reinterpret_cast<rocksdb_native_t *>(req->handle.req.db);
 
-  if (err < 0) {
-    err = js_throw_error(env, uv_err_name(err), uv_strerror(err));
-    assert(err == 0);
+  auto env = req->env;
 
-    throw js_pending_exception;
-  }
+  js_handle_scope_t *scope;
+  err = js_open_handle_scope(env, &scope);
+  assert(err == 0);
 
-  err = js_create_reference(env, ctx, req->ctx);
+  js_receiver_t ctx;
+  err = js_get_reference_value(env, req->ctx, ctx);
   assert(err == 0);
 
-  err = js_create_reference(env, on_read, req->on_read);
+  rocksdb_native_on_compact_t cb;
+  err = js_get_reference_value(env, req->on_compact, cb);
+  assert(err == 0);
+
+  req->on_compact.reset();
+  req->ctx.reset();
+
+  std::optional<js_object_t> error;
+
+  if (req->handle.error) {
+    auto code = rocksdb_native__error_code(req->handle.status, req->handle.code, req->handle.subcode);
+
+    err = js_create_error(env, code, req->handle.error, error.emplace());
+    assert(err == 0);
+  }
+
+  rocksdb_native__record_latency(db, rocksdb_native_op_compact, req->submitted, req->handle.req.started);
+
+  rocksdb_compact_cleanup(&req->handle);
+
+  if (!db->exiting) {
+    err = js_call_function_with_checkpoint(env, cb, ctx, error);
+    (void) err;
+  }
+
+  err = js_close_handle_scope(env, scope);
   assert(err == 0);
 }
 
 static js_arraybuffer_t
-rocksdb_native_write_init(js_env_t *env) {
+rocksdb_native_compact(
+  js_env_t *env,
+  js_arraybuffer_span_of_t<rocksdb_native_t, 1> db,
+  js_arraybuffer_span_of_t<rocksdb_native_column_family_t, 1> column_family,
+  bool exclusive,
+  uint32_t blob_garbage_collection_policy,
+  double blob_garbage_collection_age_cutoff,
+  uint32_t bottommost_level_compaction,
+  js_receiver_t ctx,
+  rocksdb_native_on_compact_t on_compact
+) {
   int err;
 
   js_arraybuffer_t handle;
 
-  rocksdb_native_write_batch_t *req;
+  rocksdb_native_compact_t *req;
   err = js_create_arraybuffer(env, req, handle);
   assert(err == 0);
 
   req->env = env;
   req->handle.data = req;
 
-  return handle;
-}
+  rocksdb_compact_range_options_t options;
+  rocksdb_compact_range_options_init(&options, 2);
 
-static js_arraybuffer_t
-rocksdb_native_write_buffer(
-  js_env_t *env,
-  js_arraybuffer_span_of_t<rocksdb_native_write_batch_t, 1> req,
-  uint32_t capacity
-) {
-  int err;
+  options.exclusive_manual_compaction = exclusive;
+  options.blob_garbage_collection_policy = rocksdb_blob_garbage_collection_policy_t(blob_garbage_collection_policy);
+  options.blob_garbage_collection_age_cutoff = blob_garbage_collection_age_cutoff;
+  options.bottommost_level_compaction = rocksdb_bottommost_level_compaction_t(bottommost_level_compaction);
+  options.canceled = &req->canceled;
 
-  js_arraybuffer_t handle;
+  req->submitted = uv_hrtime();
 
-  rocksdb_write_t *writes;
-  err = js_create_arraybuffer(env, capacity, writes, handle);
+  err = rocksdb_compact(&db->handle, &req->handle, column_family->handle, &options, rocksdb_native__on_compact);
+
+  if (err < 0) {
+    err = js_throw_error(env, uv_err_name(err), uv_strerror(err));
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  err = js_create_reference(env, ctx, req->ctx);
   assert(err == 0);
 
-  req->capacity = capacity;
-  req->writes = writes;
+  err = js_create_reference(env, on_compact, req->on_compact);
+  assert(err == 0);
 
   return handle;
 }
 
+// Manual compactions poll the flag between jobs and finish with an error once
+// it's set, leaving any work already installed in place.
 static void
-rocksdb_native__on_write(rocksdb_write_batch_t *handle, int status) {
+rocksdb_native_compact_cancel(js_env_t *env, js_arraybuffer_span_of_t<rocksdb_native_compact_t, 1> req) {
+  req->canceled.store(true, std::memory_order_release);
+}
+
+static void
+rocksdb_native_compact_range_cancel(js_env_t *env, js_arraybuffer_span_of_t<rocksdb_native_compact_range_t, 1> req) {
+  req->canceled.store(true, std::memory_order_release);
+}
+
+static void
+rocksdb_native__on_approximate_size(rocksdb_approximate_size_t *handle, int status) {
   int err;
 
   assert(status == 0);
 
-  auto req = reinterpret_cast<rocksdb_native_write_batch_t *>(handle->data);
+  auto req = reinterpret_cast<rocksdb_native_approximate_size_t *>(handle->data);
 
   auto db = reinterpret_cast<rocksdb_native_t *>(req->handle.req.db);
 
@@ -1453,11 +3478,11 @@ rocksdb_native__on_write(rocksdb_write_batch_t *handle, int status) {
   err = js_get_reference_value(env, req->ctx, ctx);
   assert(err == 0);
 
-  rocksdb_native_on_write_t cb;
-  err = js_get_reference_value(env, req->on_write, cb);
+  rocksdb_native_on_approximate_size_t cb;
+  err = js_get_reference_value(env, req->on_approximate_size, cb);
   assert(err == 0);
 
-  req->on_write.reset();
+  req->on_approximate_size.reset();
   req->ctx.reset();
 
   std::optional<js_object_t> error;
@@ -1467,10 +3492,10 @@ rocksdb_native__on_write(rocksdb_write_batch_t *handle, int status) {
     assert(err == 0);
   }
 
-  rocksdb_write_cleanup(&req->handle);
+  rocksdb_approximate_size_cleanup(&req->handle);
 
   if (!db->exiting) {
-    err = js_call_function_with_checkpoint(env, cb, ctx, error);
+    err = js_call_function_with_checkpoint(env, cb, ctx, error, req->handle.result);
     (void) err;
   }
 
@@ -1478,97 +3503,46 @@ rocksdb_native__on_write(rocksdb_write_batch_t *handle, int status) {
   assert(err == 0);
 }
 
-static void
-rocksdb_native_write(
+static js_arraybuffer_t
+rocksdb_native_approximate_size(
   js_env_t *env,
   js_arraybuffer_span_of_t<rocksdb_native_t, 1> db,
-  js_arraybuffer_span_of_t<rocksdb_native_write_batch_t, 1> req,
-  js_array_t operations,
+  js_arraybuffer_span_of_t<rocksdb_native_column_family_t, 1> column_family,
+  js_typedarray_t<> start,
+  js_typedarray_t<> end,
+  bool include_memtables,
+  bool include_files,
+  double error_margin,
   js_receiver_t ctx,
-  rocksdb_native_on_write_t on_write
+  rocksdb_native_on_approximate_size_t on_approximate_size
 ) {
   int err;
 
-  std::vector<js_object_t> elements;
-  err = js_get_array_elements(env, operations, elements);
+  rocksdb_slice_t start_slice;
+  err = js_get_typedarray_info(env, start, start_slice.data, start_slice.len);
   assert(err == 0);
 
-  const auto len = elements.size();
-
-  for (uint32_t i = 0; i < len; i++) {
-    js_object_t write = elements[i];
-
-    rocksdb_write_type_t type;
-    err = js_get_property(env, write, "type", reinterpret_cast<uint32_t &>(type));
-    assert(err == 0);
-
-    req->writes[i].type = type;
-
-    js_arraybuffer_t column_family_property;
-    err = js_get_property(env, write, "columnFamily", column_family_property);
-    assert(err == 0);
-
-    rocksdb_native_column_family_t *column_family;
-    err = js_get_arraybuffer_info(env, column_family_property, column_family);
-    assert(err == 0);
-
-    req->writes[i].column_family = column_family->handle;
-
-    js_typedarray_t property;
-
-    switch (type) {
-    case rocksdb_put: {
-      rocksdb_slice_t *key = &req->writes[i].key;
-
-      err = js_get_property(env, write, "key", property);
-      assert(err == 0);
-
-      err = js_get_typedarray_info(env, property, key->data, key->len);
-      assert(err == 0);
-
-      rocksdb_slice_t *value = &req->writes[i].value;
-
-      err = js_get_property(env, write, "value", property);
-      assert(err == 0);
-
-      err = js_get_typedarray_info(env, property, value->data, value->len);
-      assert(err == 0);
-      break;
-    }
-
-    case rocksdb_delete: {
-      rocksdb_slice_t *key = &req->writes[i].key;
-
-      err = js_get_property(env, write, "key", property);
-      assert(err == 0);
-
-      err = js_get_typedarray_info(env, property, key->data, key->len);
-      assert(err == 0);
-      break;
-    }
-
-    case rocksdb_delete_range: {
-      rocksdb_slice_t *start = &req->writes[i].start;
+  rocksdb_slice_t end_slice;
+  err = js_get_typedarray_info(env, end, end_slice.data, end_slice.len);
+  assert(err == 0);
 
-      err = js_get_property(env, write, "start", property);
-      assert(err == 0);
+  js_arraybuffer_t handle;
 
-      err = js_get_typedarray_info(env, property, start->data, start->len);
-      assert(err == 0);
+  rocksdb_native_approximate_size_t *req;
+  err = js_create_arraybuffer(env, req, handle);
+  assert(err == 0);
 
-      rocksdb_slice_t *end = &req->writes[i].end;
+  req->env = env;
+  req->handle.data = req;
 
-      err = js_get_property(env, write, "end", property);
-      assert(err == 0);
+  rocksdb_approximate_size_options_t options;
+  rocksdb_approximate_size_options_init(&options, 0);
 
-      err = js_get_typedarray_info(env, property, end->data, end->len);
-      assert(err == 0);
-      break;
-    }
-    }
-  }
+  options.include_memtables = include_memtables;
+  options.include_files = include_files;
+  options.files_size_error_margin = error_margin;
 
-  err = rocksdb_write(&db->handle, &req->handle, req->writes, len, nullptr, rocksdb_native__on_write);
+  err = rocksdb_approximate_size(&db->handle, &req->handle, column_family->handle, start_slice, end_slice, &options, rocksdb_native__on_approximate_size);
 
   if (err < 0) {
     err = js_throw_error(env, uv_err_name(err), uv_strerror(err));
@@ -1580,17 +3554,19 @@ rocksdb_native_write(
   err = js_create_reference(env, ctx, req->ctx);
   assert(err == 0);
 
-  err = js_create_reference(env, on_write, req->on_write);
+  err = js_create_reference(env, on_approximate_size, req->on_approximate_size);
   assert(err == 0);
+
+  return handle;
 }
 
 static void
-rocksdb_native__on_flush(rocksdb_flush_t *handle, int status) {
+rocksdb_native__on_key_may_exist(rocksdb_key_may_exist_t *handle, int status) {
   int err;
 
   assert(status == 0);
 
-  auto req = reinterpret_cast<rocksdb_native_flush_t *>(handle->data);
+  auto req = reinterpret_cast<rocksdb_native_key_may_exist_t *>(handle->data);
 
   auto db = reinterpret_cast<rocksdb_native_t *>(req->handle.req.db);
 
@@ -1604,11 +3580,11 @@ rocksdb_native__on_flush(rocksdb_flush_t *handle, int status) {
   err = js_get_reference_value(env, req->ctx, ctx);
   assert(err == 0);
 
-  rocksdb_native_on_flush_t cb;
-  err = js_get_reference_value(env, req->on_flush, cb);
+  rocksdb_native_on_key_may_exist_t cb;
+  err = js_get_reference_value(env, req->on_key_may_exist, cb);
   assert(err == 0);
 
-  req->on_flush.reset();
+  req->on_key_may_exist.reset();
   req->ctx.reset();
 
   std::optional<js_object_t> error;
@@ -1618,7 +3594,9 @@ rocksdb_native__on_flush(rocksdb_flush_t *handle, int status) {
     assert(err == 0);
   }
 
-  rocksdb_flush_cleanup(&req->handle);
+  delete[] req->keys;
+
+  rocksdb_key_may_exist_cleanup(&req->handle);
 
   if (!db->exiting) {
     err = js_call_function_with_checkpoint(env, cb, ctx, error);
@@ -1629,28 +3607,63 @@ rocksdb_native__on_flush(rocksdb_flush_t *handle, int status) {
   assert(err == 0);
 }
 
+// Sets bit i of the bitmap unless key i is definitely absent, as decided from
+// the memtables and filter blocks alone. With confirm, candidates are checked
+// with a Get that doesn't materialize the value, so set bits are exact.
 static js_arraybuffer_t
-rocksdb_native_flush(
+rocksdb_native_key_may_exist(
   js_env_t *env,
   js_arraybuffer_span_of_t<rocksdb_native_t, 1> db,
   js_arraybuffer_span_of_t<rocksdb_native_column_family_t, 1> column_family,
+  js_array_t keys,
+  js_typedarray_t<uint8_t> bitmap,
+  bool confirm,
+  std::optional<js_arraybuffer_span_of_t<rocksdb_native_snapshot_t, 1>> snapshot,
   js_receiver_t ctx,
-  rocksdb_native_on_flush_t on_flush
+  rocksdb_native_on_key_may_exist_t on_key_may_exist
 ) {
   int err;
 
+  std::vector<js_typedarray_t<>> elements;
+  err = js_get_array_elements(env, keys, elements);
+  assert(err == 0);
+
+  const auto len = elements.size();
+
+  uint8_t *bits;
+  size_t bits_len;
+  err = js_get_typedarray_info(env, bitmap, bits, bits_len);
+  assert(err == 0);
+
+  assert(bits_len * 8 >= len);
+
   js_arraybuffer_t handle;
 
-  rocksdb_native_flush_t *req;
+  rocksdb_native_key_may_exist_t *req;
   err = js_create_arraybuffer(env, req, handle);
   assert(err == 0);
 
   req->env = env;
   req->handle.data = req;
+  req->keys = new rocksdb_slice_t[len];
 
-  err = rocksdb_flush(&db->handle, &req->handle, column_family->handle, nullptr, rocksdb_native__on_flush);
+  for (size_t i = 0; i < len; i++) {
+    err = js_get_typedarray_info(env, elements[i], req->keys[i].data, req->keys[i].len);
+    assert(err == 0);
+  }
+
+  rocksdb_key_may_exist_options_t options;
+  rocksdb_key_may_exist_options_init(&options, 0);
+
+  options.confirm = confirm;
+
+  if (snapshot) options.snapshot = &snapshot.value()->handle;
+
+  err = rocksdb_key_may_exist(&db->handle, &req->handle, column_family->handle, req->keys, len, bits, &options, rocksdb_native__on_key_may_exist);
 
   if (err < 0) {
+    delete[] req->keys;
+
     err = js_throw_error(env, uv_err_name(err), uv_strerror(err));
     assert(err == 0);
 
@@ -1660,22 +3673,24 @@ rocksdb_native_flush(
   err = js_create_reference(env, ctx, req->ctx);
   assert(err == 0);
 
-  err = js_create_reference(env, on_flush, req->on_flush);
+  err = js_create_reference(env, on_key_may_exist, req->on_key_may_exist);
   assert(err == 0);
 
   return handle;
 }
 
 static void
-rocksdb_native__on_compact_range(rocksdb_compact_range_t *handle, int status) {
+rocksdb_native__on_table_properties(rocksdb_table_properties_t *handle, int status) {
   int err;
 
   assert(status == 0);
 
-  auto req = reinterpret_cast<rocksdb_native_compact_range_t *>(handle->data);
+  auto req = reinterpret_cast<rocksdb_native_table_properties_t *>(handle->data);
 
   auto db = reinterpret_cast<rocksdb_native_t *>(req->handle.req.db);
 
+  auto len = req->handle.len;
+
   auto env = req->env;
 
   js_handle_scope_t *scope;
@@ -1686,24 +3701,54 @@ rocksdb_native__on_compact_range(rocksdb_compact_range_t *handle, int status) {
   err = js_get_reference_value(env, req->ctx, ctx);
   assert(err == 0);
 
-  rocksdb_native_on_compact_range_t cb;
-  err = js_get_reference_value(env, req->on_compact_range, cb);
+  rocksdb_native_on_table_properties_t cb;
+  err = js_get_reference_value(env, req->on_table_properties, cb);
   assert(err == 0);
 
-  req->on_compact_range.reset();
+  req->on_table_properties.reset();
   req->ctx.reset();
 
   std::optional<js_object_t> error;
 
+  js_array_t files;
+  err = js_create_array(env, len, files);
+  assert(err == 0);
+
   if (req->handle.error) {
     err = js_create_error(env, uv_err_name(req->handle.status), req->handle.error, error.emplace());
     assert(err == 0);
+  } else if (!db->exiting) {
+    for (size_t i = 0; i < len; i++) {
+      auto &properties = req->handle.properties[i];
+
+      js_object_t file;
+      err = js_create_object(env, file);
+      assert(err == 0);
+
+      err = js_set_property(env, file, "path", properties.path);
+      assert(err == 0);
+
+      err = js_set_property(env, file, "entries", properties.entries);
+      assert(err == 0);
+
+      err = js_set_property(env, file, "deletions", properties.deletions);
+      assert(err == 0);
+
+      err = js_set_property(env, file, "rangeDeletions", properties.range_deletions);
+      assert(err == 0);
+
+      err = js_set_property(env, file, "dataSize", properties.data_size);
+      assert(err == 0);
+
+      err = js_set_element(env, files, i, file);
+      assert(err == 0);
+    }
   }
 
-  rocksdb_compact_range_cleanup(&req->handle);
+  rocksdb_table_properties_cleanup(&req->handle);
 
   if (!db->exiting) {
-    err = js_call_function_with_checkpoint(env, cb, ctx, error);
+    err = js_call_function_with_checkpoint(env, cb, ctx, error, files);
     (void) err;
   }
 
@@ -1712,47 +3757,25 @@ rocksdb_native__on_compact_range(rocksdb_compact_range_t *handle, int status) {
 }
 
 static js_arraybuffer_t
-rocksdb_native_compact_range(
+rocksdb_native_table_properties(
   js_env_t *env,
   js_arraybuffer_span_of_t<rocksdb_native_t, 1> db,
   js_arraybuffer_span_of_t<rocksdb_native_column_family_t, 1> column_family,
-  js_typedarray_t<> start,
-  js_typedarray_t<> end,
-  bool exclusive,
-  uint32_t blob_garbage_collection_policy,
-  double blob_garbage_collection_age_cutoff,
-  uint32_t bottommost_level_compaction,
   js_receiver_t ctx,
-  rocksdb_native_on_compact_range_t on_compact_range
+  rocksdb_native_on_table_properties_t on_table_properties
 ) {
   int err;
 
-  rocksdb_slice_t start_slice;
-  err = js_get_typedarray_info(env, start, start_slice.data, start_slice.len);
-  assert(err == 0);
-
-  rocksdb_slice_t end_slice;
-  err = js_get_typedarray_info(env, end, end_slice.data, end_slice.len);
-  assert(err == 0);
-
   js_arraybuffer_t handle;
 
-  rocksdb_native_compact_range_t *req;
+  rocksdb_native_table_properties_t *req;
   err = js_create_arraybuffer(env, req, handle);
-  assert(err == 0);
-
-  req->env = env;
-  req->handle.data = req;
-
-  rocksdb_compact_range_options_t options;
-  rocksdb_compact_range_options_init(&options, 1);
-
-  options.exclusive_manual_compaction = exclusive;
-  options.blob_garbage_collection_policy = rocksdb_blob_garbage_collection_policy_t(blob_garbage_collection_policy);
-  options.blob_garbage_collection_age_cutoff = blob_garbage_collection_age_cutoff;
-  options.bottommost_level_compaction = rocksdb_bottommost_level_compaction_t(bottommost_level_compaction);
+  assert(err == 0);
 
-  err = rocksdb_compact_range(&db->handle, &req->handle, column_family->handle, start_slice, end_slice, &options, rocksdb_native__on_compact_range);
+  req->env = env;
+  req->handle.data = req;
+
+  err = rocksdb_table_properties(&db->handle, &req->handle, column_family->handle, rocksdb_native__on_table_properties);
 
   if (err < 0) {
     err = js_throw_error(env, uv_err_name(err), uv_strerror(err));
@@ -1764,89 +3787,79 @@ rocksdb_native_compact_range(
   err = js_create_reference(env, ctx, req->ctx);
   assert(err == 0);
 
-  err = js_create_reference(env, on_compact_range, req->on_compact_range);
+  err = js_create_reference(env, on_table_properties, req->on_table_properties);
   assert(err == 0);
 
   return handle;
 }
 
 static void
-rocksdb_native__on_compact(rocksdb_compact_t *handle, int status) {
+rocksdb_native_trace_start(
+  js_env_t *env,
+  js_arraybuffer_span_of_t<rocksdb_native_t, 1> db,
+  std::string path,
+  uint64_t sampling,
+  uint64_t max_size
+) {
   int err;
 
-  assert(status == 0);
-
-  auto req = reinterpret_cast<rocksdb_native_compact_t *>(handle->data);
-
-  auto db = reinterpret_cast<rocksdb_native_t *>(req->handle.req.db);
-
-  auto env = req->env;
-
-  js_handle_scope_t *scope;
-  err = js_open_handle_scope(env, &scope);
-  assert(err == 0);
+  rocksdb_trace_options_t options = {
+    .version = 0,
+    .sampling_frequency = sampling,
+    .max_trace_file_size = max_size
+  };
 
-  js_receiver_t ctx;
-  err = js_get_reference_value(env, req->ctx, ctx);
-  assert(err == 0);
+  err = rocksdb_trace_start(&db->handle, path.c_str(), &options);
 
-  rocksdb_native_on_compact_t cb;
-  err = js_get_reference_value(env, req->on_compact, cb);
-  assert(err == 0);
+  if (err < 0) {
+    err = js_throw_error(env, uv_err_name(err), uv_strerror(err));
+    assert(err == 0);
 
-  req->on_compact.reset();
-  req->ctx.reset();
+    throw js_pending_exception;
+  }
+}
 
-  std::optional<js_object_t> error;
+static void
+rocksdb_native_trace_end(js_env_t *env, js_arraybuffer_span_of_t<rocksdb_native_t, 1> db) {
+  int err = rocksdb_trace_end(&db->handle);
 
-  if (req->handle.error) {
-    err = js_create_error(env, uv_err_name(req->handle.status), req->handle.error, error.emplace());
+  if (err < 0) {
+    err = js_throw_error(env, uv_err_name(err), uv_strerror(err));
     assert(err == 0);
-  }
-
-  rocksdb_compact_cleanup(&req->handle);
 
-  if (!db->exiting) {
-    err = js_call_function_with_checkpoint(env, cb, ctx, error);
-    (void) err;
+    throw js_pending_exception;
   }
-
-  err = js_close_handle_scope(env, scope);
-  assert(err == 0);
 }
 
-static js_arraybuffer_t
-rocksdb_native_compact(
+static void
+rocksdb_native_block_cache_trace_start(
   js_env_t *env,
   js_arraybuffer_span_of_t<rocksdb_native_t, 1> db,
-  js_arraybuffer_span_of_t<rocksdb_native_column_family_t, 1> column_family,
-  bool exclusive,
-  uint32_t blob_garbage_collection_policy,
-  double blob_garbage_collection_age_cutoff,
-  uint32_t bottommost_level_compaction,
-  js_receiver_t ctx,
-  rocksdb_native_on_compact_t on_compact
+  std::string path,
+  uint64_t sampling,
+  uint64_t max_size
 ) {
   int err;
 
-  js_arraybuffer_t handle;
-
-  rocksdb_native_compact_t *req;
-  err = js_create_arraybuffer(env, req, handle);
-  assert(err == 0);
+  rocksdb_trace_options_t options = {
+    .version = 0,
+    .sampling_frequency = sampling,
+    .max_trace_file_size = max_size
+  };
 
-  req->env = env;
-  req->handle.data = req;
+  err = rocksdb_block_cache_trace_start(&db->handle, path.c_str(), &options);
 
-  rocksdb_compact_range_options_t options;
-  rocksdb_compact_range_options_init(&options, 1);
+  if (err < 0) {
+    err = js_throw_error(env, uv_err_name(err), uv_strerror(err));
+    assert(err == 0);
 
-  options.exclusive_manual_compaction = exclusive;
-  options.blob_garbage_collection_policy = rocksdb_blob_garbage_collection_policy_t(blob_garbage_collection_policy);
-  options.blob_garbage_collection_age_cutoff = blob_garbage_collection_age_cutoff;
-  options.bottommost_level_compaction = rocksdb_bottommost_level_compaction_t(bottommost_level_compaction);
+    throw js_pending_exception;
+  }
+}
 
-  err = rocksdb_compact(&db->handle, &req->handle, column_family->handle, &options, rocksdb_native__on_compact);
+static void
+rocksdb_native_block_cache_trace_end(js_env_t *env, js_arraybuffer_span_of_t<rocksdb_native_t, 1> db) {
+  int err = rocksdb_block_cache_trace_end(&db->handle);
 
   if (err < 0) {
     err = js_throw_error(env, uv_err_name(err), uv_strerror(err));
@@ -1854,28 +3867,55 @@ rocksdb_native_compact(
 
     throw js_pending_exception;
   }
+}
 
-  err = js_create_reference(env, ctx, req->ctx);
-  assert(err == 0);
+static void
+rocksdb_native__on_replay_result(rocksdb_replay_t *handle, const rocksdb_replay_result_t *result) {
+  auto req = reinterpret_cast<rocksdb_native_replay_t *>(handle->data);
 
-  err = js_create_reference(env, on_compact, req->on_compact);
-  assert(err == 0);
+  rocksdb_native_replay_op_t op;
 
-  return handle;
+  switch (result->type) {
+  case rocksdb_trace_get:
+    op = rocksdb_native_replay_op_get;
+    break;
+  case rocksdb_trace_write:
+    op = rocksdb_native_replay_op_write;
+    break;
+  case rocksdb_trace_iterator_seek:
+  case rocksdb_trace_iterator_seek_for_prev:
+    op = rocksdb_native_replay_op_seek;
+    break;
+  case rocksdb_trace_multi_get:
+    op = rocksdb_native_replay_op_multi_get;
+    break;
+  default:
+    return;
+  }
+
+  uv_mutex_lock(&req->lock);
+
+  rocksdb_native__histogram_record(&req->latency[op], result->latency);
+
+  uv_mutex_unlock(&req->lock);
 }
 
 static void
-rocksdb_native__on_approximate_size(rocksdb_approximate_size_t *handle, int status) {
+rocksdb_native__on_replay(rocksdb_replay_t *handle, int status) {
   int err;
 
   assert(status == 0);
 
-  auto req = reinterpret_cast<rocksdb_native_approximate_size_t *>(handle->data);
+  auto req = reinterpret_cast<rocksdb_native_replay_t *>(handle->data);
 
   auto db = reinterpret_cast<rocksdb_native_t *>(req->handle.req.db);
 
   auto env = req->env;
 
+  uv_mutex_destroy(&req->lock);
+
+  req->column_families.~vector();
+
   js_handle_scope_t *scope;
   err = js_open_handle_scope(env, &scope);
   assert(err == 0);
@@ -1884,24 +3924,33 @@ rocksdb_native__on_approximate_size(rocksdb_approximate_size_t *handle, int stat
   err = js_get_reference_value(env, req->ctx, ctx);
   assert(err == 0);
 
-  rocksdb_native_on_approximate_size_t cb;
-  err = js_get_reference_value(env, req->on_approximate_size, cb);
+  rocksdb_native_on_replay_t cb;
+  err = js_get_reference_value(env, req->on_replay, cb);
   assert(err == 0);
 
-  req->on_approximate_size.reset();
+  req->on_replay.reset();
   req->ctx.reset();
 
   std::optional<js_object_t> error;
+  std::optional<js_arraybuffer_t> latency;
 
   if (req->handle.error) {
     err = js_create_error(env, uv_err_name(req->handle.status), req->handle.error, error.emplace());
     assert(err == 0);
+  } else {
+    double *data;
+    err = js_create_arraybuffer(env, rocksdb_native_replay_op_count * 8, data, latency.emplace());
+    assert(err == 0);
+
+    for (int op = 0; op < rocksdb_native_replay_op_count; op++) {
+      rocksdb_native__histogram_summary(&req->latency[op], data + op * 8);
+    }
   }
 
-  rocksdb_approximate_size_cleanup(&req->handle);
+  rocksdb_replay_cleanup(&req->handle);
 
   if (!db->exiting) {
-    err = js_call_function_with_checkpoint(env, cb, ctx, error, req->handle.result);
+    err = js_call_function_with_checkpoint(env, cb, ctx, error, latency);
     (void) err;
   }
 
@@ -1910,47 +3959,53 @@ rocksdb_native__on_approximate_size(rocksdb_approximate_size_t *handle, int stat
 }
 
 static js_arraybuffer_t
-rocksdb_native_approximate_size(
+rocksdb_native_replay(
   js_env_t *env,
   js_arraybuffer_span_of_t<rocksdb_native_t, 1> db,
-  js_arraybuffer_span_of_t<rocksdb_native_column_family_t, 1> column_family,
-  js_typedarray_t<> start,
-  js_typedarray_t<> end,
-  bool include_memtables,
-  bool include_files,
-  double error_margin,
+  std::string path,
+  double speedup,
+  uint32_t concurrency,
   js_receiver_t ctx,
-  rocksdb_native_on_approximate_size_t on_approximate_size
+  rocksdb_native_on_replay_t on_replay
 ) {
   int err;
 
-  rocksdb_slice_t start_slice;
-  err = js_get_typedarray_info(env, start, start_slice.data, start_slice.len);
-  assert(err == 0);
-
-  rocksdb_slice_t end_slice;
-  err = js_get_typedarray_info(env, end, end_slice.data, end_slice.len);
-  assert(err == 0);
-
   js_arraybuffer_t handle;
 
-  rocksdb_native_approximate_size_t *req;
+  rocksdb_native_replay_t *req;
   err = js_create_arraybuffer(env, req, handle);
   assert(err == 0);
 
   req->env = env;
   req->handle.data = req;
 
-  rocksdb_approximate_size_options_t options;
-  rocksdb_approximate_size_options_init(&options, 0);
+  new (&req->column_families) std::vector<rocksdb_column_family_t *>();
 
-  options.include_memtables = include_memtables;
-  options.include_files = include_files;
-  options.files_size_error_margin = error_margin;
+  // The trace refers to column families by ID, so the replayer needs every
+  // handle that's currently open.
+  for (auto &column_family : db->column_families) {
+    req->column_families.push_back(column_family->handle);
+  }
 
-  err = rocksdb_approximate_size(&db->handle, &req->handle, column_family->handle, start_slice, end_slice, &options, rocksdb_native__on_approximate_size);
+  memset(req->latency, 0, sizeof(req->latency));
+
+  err = uv_mutex_init(&req->lock);
+  assert(err == 0);
+
+  rocksdb_replay_options_t options = {
+    .version = 0,
+    .fast_forward = speedup,
+    .num_threads = concurrency,
+    .on_result = rocksdb_native__on_replay_result
+  };
+
+  err = rocksdb_replay(&db->handle, &req->handle, path.c_str(), req->column_families.data(), req->column_families.size(), &options, rocksdb_native__on_replay);
 
   if (err < 0) {
+    uv_mutex_destroy(&req->lock);
+
+    req->column_families.~vector();
+
     err = js_throw_error(env, uv_err_name(err), uv_strerror(err));
     assert(err == 0);
 
@@ -1960,7 +4015,7 @@ rocksdb_native_approximate_size(
   err = js_create_reference(env, ctx, req->ctx);
   assert(err == 0);
 
-  err = js_create_reference(env, on_approximate_size, req->on_approximate_size);
+  err = js_create_reference(env, on_replay, req->on_replay);
   assert(err == 0);
 
   return handle;
@@ -2080,6 +4135,182 @@ rocksdb_native_stats_level_set(js_env_t *env, js_arraybuffer_span_of_t<rocksdb_n
   }
 }
 
+static uint64_t
+rocksdb_native_ticker_get(js_env_t *env, js_arraybuffer_span_of_t<rocksdb_native_t, 1> db, uint32_t ticker) {
+  int err;
+
+  uint64_t value;
+  err = rocksdb_ticker_get(&db->handle, rocksdb_ticker_t(ticker), &value);
+
+  if (err < 0) {
+    err = js_throw_error(env, uv_err_name(err), uv_strerror(err));
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  return value;
+}
+
+static void
+rocksdb_native_statistics(
+  js_env_t *env,
+  js_arraybuffer_span_of_t<rocksdb_native_t, 1> db,
+  js_typedarray_t<uint64_t> tickers,
+  js_typedarray_t<double> histograms
+) {
+  int err;
+
+  uint64_t *ticker_data;
+  size_t tickers_len;
+  err = js_get_typedarray_info(env, tickers, ticker_data, tickers_len);
+  assert(err == 0);
+
+  double *histogram_data;
+  size_t histograms_len;
+  err = js_get_typedarray_info(env, histograms, histogram_data, histograms_len);
+  assert(err == 0);
+
+  // p50, p95, p99, max, count and sum for each histogram
+  std::vector<rocksdb_histogram_data_t> data(histograms_len / 6);
+
+  err = rocksdb_statistics_get(&db->handle, ticker_data, tickers_len, data.data(), data.size());
+
+  if (err < 0) {
+    err = js_throw_error(env, uv_err_name(err), uv_strerror(err));
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  for (size_t i = 0, n = data.size(); i < n; i++) {
+    auto &histogram = data[i];
+
+    histogram_data[i * 6 + 0] = histogram.median;
+    histogram_data[i * 6 + 1] = histogram.percentile95;
+    histogram_data[i * 6 + 2] = histogram.percentile99;
+    histogram_data[i * 6 + 3] = histogram.max;
+    histogram_data[i * 6 + 4] = double(histogram.count);
+    histogram_data[i * 6 + 5] = double(histogram.sum);
+  }
+}
+
+static void
+rocksdb_native_latency(
+  js_env_t *env,
+  js_arraybuffer_span_of_t<rocksdb_native_t, 1> db,
+  js_typedarray_t<double> result
+) {
+  int err;
+
+  double *data;
+  size_t len;
+  err = js_get_typedarray_info(env, result, data, len);
+  assert(err == 0);
+
+  // count, min, max, mean, p50, p90, p99 and p999 for each operation and phase
+  assert(len == rocksdb_native_op_count * rocksdb_native_phase_count * 8);
+
+  for (int op = 0; op < rocksdb_native_op_count; op++) {
+    for (int phase = 0; phase < rocksdb_native_phase_count; phase++) {
+      rocksdb_native__histogram_summary(&db->latency[op][phase], data);
+
+      data += 8;
+    }
+  }
+}
+
+static void
+rocksdb_native_latency_reset(js_env_t *env, js_arraybuffer_span_of_t<rocksdb_native_t, 1> db) {
+  memset(db->latency, 0, sizeof(db->latency));
+}
+
+// Integer properties backing the per column family memory breakdown, in the
+// order they're written to the result array.
+static const char *rocksdb_native__memory_properties[] = {
+  "rocksdb.cur-size-active-mem-table",
+  "rocksdb.cur-size-all-mem-tables",
+  "rocksdb.size-all-mem-tables",
+  "rocksdb.estimate-table-readers-mem",
+  "rocksdb.block-cache-usage",
+  "rocksdb.block-cache-pinned-usage",
+  "rocksdb.blob-cache-usage",
+};
+
+static void
+rocksdb_native_memory_usage(
+  js_env_t *env,
+  js_arraybuffer_span_of_t<rocksdb_native_t, 1> db,
+  js_arraybuffer_span_of_t<rocksdb_native_column_family_t, 1> column_family,
+  js_typedarray_t<uint64_t> result
+) {
+  int err;
+
+  uint64_t *data;
+  size_t len;
+  err = js_get_typedarray_info(env, result, data, len);
+  assert(err == 0);
+
+  const auto n = sizeof(rocksdb_native__memory_properties) / sizeof(rocksdb_native__memory_properties[0]);
+
+  assert(len >= n);
+
+  for (size_t i = 0; i < n; i++) {
+    err = rocksdb_property_get_int(&db->handle, column_family->handle, rocksdb_native__memory_properties[i], &data[i]);
+
+    // Not every property is available for every configuration, such as the
+    // blob cache usage when blob files are disabled. Mark those rather than
+    // report them as no memory used.
+    if (err < 0) data[i] = UINT64_MAX;
+  }
+}
+
+static std::optional<uint64_t>
+rocksdb_native_property_get_int(
+  js_env_t *env,
+  js_arraybuffer_span_of_t<rocksdb_native_t, 1> db,
+  js_arraybuffer_span_of_t<rocksdb_native_column_family_t, 1> column_family,
+  std::string name
+) {
+  uint64_t value;
+  int err = rocksdb_property_get_int(&db->handle, column_family->handle, name.c_str(), &value);
+
+  if (err < 0) return std::nullopt;
+
+  return value;
+}
+
+static void
+rocksdb_native_approximate_memory_usage(
+  js_env_t *env,
+  js_arraybuffer_span_of_t<rocksdb_native_t, 1> db,
+  js_typedarray_t<uint64_t> result
+) {
+  int err;
+
+  uint64_t *data;
+  size_t len;
+  err = js_get_typedarray_info(env, result, data, len);
+  assert(err == 0);
+
+  assert(len >= 4);
+
+  rocksdb_memory_usage_t usage;
+  err = rocksdb_approximate_memory_usage(&db->handle, &usage);
+
+  if (err < 0) {
+    err = js_throw_error(env, uv_err_name(err), uv_strerror(err));
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  data[0] = usage.mem_table_total;
+  data[1] = usage.mem_table_unflushed;
+  data[2] = usage.table_readers_total;
+  data[3] = usage.cache_total;
+}
+
 static std::optional<std::string>
 rocksdb_native_property_get(
   js_env_t *env,
@@ -2152,6 +4383,35 @@ rocksdb_native_exports(js_env_t *env, js_value_t *exports) {
   V("suspend", rocksdb_native_suspend)
   V("resume", rocksdb_native_resume)
 
+  V("blockCacheInit", rocksdb_native_block_cache_init)
+  V("blockCacheDestroy", rocksdb_native_block_cache_destroy)
+  V("blockCacheCapacity", rocksdb_native_block_cache_capacity)
+  V("blockCacheSetCapacity", rocksdb_native_block_cache_set_capacity)
+  V("blockCacheUsage", rocksdb_native_block_cache_usage)
+  V("blockCachePinnedUsage", rocksdb_native_block_cache_pinned_usage)
+
+  V("writeBufferManagerInit", rocksdb_native_write_buffer_manager_init)
+  V("writeBufferManagerDestroy", rocksdb_native_write_buffer_manager_destroy)
+  V("writeBufferManagerBufferSize", rocksdb_native_write_buffer_manager_buffer_size)
+  V("writeBufferManagerSetBufferSize", rocksdb_native_write_buffer_manager_set_buffer_size)
+  V("writeBufferManagerMemoryUsage", rocksdb_native_write_buffer_manager_memory_usage)
+  V("writeBufferManagerStalled", rocksdb_native_write_buffer_manager_stalled)
+
+  V("rateLimiterInit", rocksdb_native_rate_limiter_init)
+  V("rateLimiterDestroy", rocksdb_native_rate_limiter_destroy)
+  V("rateLimiterBytesPerSecond", rocksdb_native_rate_limiter_bytes_per_second)
+  V("rateLimiterSetBytesPerSecond", rocksdb_native_rate_limiter_set_bytes_per_second)
+  V("rateLimiterTotalBytesThrough", rocksdb_native_rate_limiter_total_bytes_through)
+  V("rateLimiterTotalRequests", rocksdb_native_rate_limiter_total_requests)
+
+  V("executorInit", rocksdb_native_executor_init)
+  V("executorDestroy", rocksdb_native_executor_destroy)
+  V("executorPending", rocksdb_native_executor_pending)
+
+  V("dropFilterInit", rocksdb_native_drop_filter_init)
+  V("dropFilterUpdate", rocksdb_native_drop_filter_update)
+  V("dropFilterDestroy", rocksdb_native_drop_filter_destroy)
+
   V("columnFamilyInit", rocksdb_native_column_family_init)
   V("columnFamilyDestroy", rocksdb_native_column_family_destroy)
 
@@ -2171,13 +4431,29 @@ rocksdb_native_exports(js_env_t *env, js_value_t *exports) {
 
   V("statsLevelGet", rocksdb_native_stats_level_get)
   V("statsLevelSet", rocksdb_native_stats_level_set)
+  V("tickerGet", rocksdb_native_ticker_get)
+  V("statistics", rocksdb_native_statistics)
+  V("latency", rocksdb_native_latency)
+  V("latencyReset", rocksdb_native_latency_reset)
+  V("memoryUsage", rocksdb_native_memory_usage)
+  V("approximateMemoryUsage", rocksdb_native_approximate_memory_usage)
 
   V("flush", rocksdb_native_flush)
   V("compact", rocksdb_native_compact)
   V("compactRange", rocksdb_native_compact_range)
+  V("compactCancel", rocksdb_native_compact_cancel)
+  V("compactRangeCancel", rocksdb_native_compact_range_cancel)
+  V("keyMayExist", rocksdb_native_key_may_exist)
   V("approximateSize", rocksdb_native_approximate_size)
+  V("tableProperties", rocksdb_native_table_properties)
+  V("traceStart", rocksdb_native_trace_start)
+  V("traceEnd", rocksdb_native_trace_end)
+  V("blockCacheTraceStart", rocksdb_native_block_cache_trace_start)
+  V("blockCacheTraceEnd", rocksdb_native_block_cache_trace_end)
+  V("replay", rocksdb_native_replay)
   V("currentWalFile", rocksdb_native_current_wal_file)
   V("propertyGet", rocksdb_native_property_get)
+  V("propertyGetInt", rocksdb_native_property_get_int)
 
   V("snapshotCreate", rocksdb_native_snapshot_create)
   V("snapshotDestroy", rocksdb_native_snapshot_destroy)
@@ -2196,6 +4472,30 @@ rocksdb_native_exports(js_env_t *env, js_value_t *exports) {
   V("PUT", rocksdb_put)
   V("DELETE", rocksdb_delete)
   V("DELETE_RANGE", rocksdb_delete_range)
+
+  V("ROW_CACHE_HIT", rocksdb_row_cache_hit)
+  V("ROW_CACHE_MISS", rocksdb_row_cache_miss)
+#undef V
+
+#define V(name, len, fn) \
+  { \
+    js_value_t *names; \
+    err = js_create_array_with_length(env, len, &names); \
+    assert(err == 0); \
+    for (uint32_t i = 0; i < len; i++) { \
+      js_value_t *val; \
+      err = js_create_string_utf8(env, reinterpret_cast<const utf8_t *>(fn(i)), -1, &val); \
+      assert(err == 0); \
+      err = js_set_element(env, names, i, val); \
+      assert(err == 0); \
+    } \
+    err = js_set_named_property(env, exports, name, names); \
+    assert(err == 0); \
+  }
+
+  V("TICKERS", rocksdb_ticker_count, rocksdb_ticker_name)
+  V("HISTOGRAMS", rocksdb_histogram_count, rocksdb_histogram_name)
+  V("PERF_FIELDS", rocksdb_native_perf_field_count, rocksdb_native_perf_field_name)
 #undef V
 
   return exports;
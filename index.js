@@ -1,7 +1,14 @@
+const BlockCache = require('./lib/block-cache')
 const ColumnFamily = require('./lib/column-family')
+const DropFilter = require('./lib/drop-filter')
+const Executor = require('./lib/executor')
+const ExpiryPolicy = require('./lib/expiry-policy')
 const Iterator = require('./lib/iterator')
+const RateLimiter = require('./lib/rate-limiter')
 const Snapshot = require('./lib/snapshot')
 const State = require('./lib/state')
+const Statistics = require('./lib/statistics')
+const WriteBufferManager = require('./lib/write-buffer-manager')
 const { BloomFilterPolicy, RibbonFilterPolicy } = require('./lib/filter-policy')
 const constants = require('./lib/constants')
 
@@ -21,6 +28,7 @@ class RocksDB {
     this._keyEncoding = keyEncoding
     this._valueEncoding = valueEncoding
     this._index = -1
+    this._listeners = null
 
     this._state.addSession(this)
   }
@@ -41,6 +49,10 @@ class RocksDB {
     return this._state.stats
   }
 
+  get writePressure() {
+    return this._state.writePressure
+  }
+
   get snapshotted() {
     return this._snapshot !== null
   }
@@ -87,6 +99,8 @@ class RocksDB {
 
     if (this._index !== -1) this._state.removeSession(this)
 
+    this._listeners = null
+
     if (force) {
       while (this._state.sessions.length > 0) {
         await this._state.sessions[this._state.sessions.length - 1].close()
@@ -158,6 +172,8 @@ class RocksDB {
   }
 
   async get(key, opts) {
+    maybePerf(opts)
+
     const batch = this.read({ ...opts, capacity: 1, autoDestroy: true })
     const value = batch.get(key)
     batch.tryFlush()
@@ -165,18 +181,24 @@ class RocksDB {
   }
 
   async put(key, value, opts) {
+    maybePerf(opts)
+
     const batch = this.write({ ...opts, capacity: 1, autoDestroy: true })
     batch.tryPut(key, value)
     await batch.flush()
   }
 
   async delete(key, opts) {
+    maybePerf(opts)
+
     const batch = this.write({ ...opts, capacity: 1, autoDestroy: true })
     batch.tryDelete(key)
     await batch.flush()
   }
 
   async deleteRange(start, end, opts) {
+    maybePerf(opts)
+
     const batch = this.write({ ...opts, capacity: 1, autoDestroy: true })
     batch.tryDeleteRange(start, end)
     await batch.flush()
@@ -201,10 +223,29 @@ class RocksDB {
     await this._state.compactRange(this, start, end, opts)
   }
 
+  // Bitmap with bit i clear if keys[i] is definitely absent, decided from the
+  // memtables and filters alone unless `confirm` is set.
+  async has(keys, opts = {}) {
+    maybeClosed(this)
+
+    if (!Array.isArray(keys)) {
+      const bitmap = await this._state.keyMayExist(this, [keys], opts)
+      return bitmap[0] === 1
+    }
+
+    return this._state.keyMayExist(this, keys, opts)
+  }
+
   async approximateSize(start, end, opts = {}) {
     return this._state.approximateSize(this, start, end, opts)
   }
 
+  async tableProperties() {
+    maybeClosed(this)
+
+    return this._state.tableProperties(this)
+  }
+
   async currentWalFile() {
     maybeClosed(this)
 
@@ -223,6 +264,48 @@ class RocksDB {
     await this._state.setStatsLevel(level)
   }
 
+  async statistics(result = new Statistics()) {
+    maybeClosed(this)
+
+    return this._state.statistics(result)
+  }
+
+  async memoryUsage() {
+    maybeClosed(this)
+
+    return this._state.memoryUsage()
+  }
+
+  async startTrace(path, opts) {
+    maybeClosed(this)
+
+    return this._state.startTrace(path, opts)
+  }
+
+  async endTrace(opts) {
+    maybeClosed(this)
+
+    return this._state.endTrace(opts)
+  }
+
+  async startBlockCacheTrace(path, opts) {
+    maybeClosed(this)
+
+    return this._state.startTrace(path, { ...opts, blockCache: true })
+  }
+
+  async endBlockCacheTrace() {
+    maybeClosed(this)
+
+    return this._state.endTrace({ blockCache: true })
+  }
+
+  async replayTrace(path, opts) {
+    maybeClosed(this)
+
+    return this._state.replayTrace(path, opts)
+  }
+
   async getProperty(name) {
     maybeClosed(this)
 
@@ -239,8 +322,66 @@ class RocksDB {
     this._state.handles.dec()
   }
 
-  diagnostics() {
-    return this._state.diagnostics()
+  // Reads the ticker backed counters, such as the row cache hits and misses,
+  // into stats. The JS counters are always current.
+  refreshStats() {
+    this._state.updateTickerStats()
+
+    return this._state.stats
+  }
+
+  diagnostics(opts) {
+    return this._state.diagnostics(opts)
+  }
+
+  resetLatency() {
+    this._state.resetLatency()
+  }
+
+  // Background events are delivered to every open session listening for them
+  on(name, fn) {
+    return this._addListener(name, fn, false)
+  }
+
+  once(name, fn) {
+    return this._addListener(name, fn, true)
+  }
+
+  off(name, fn) {
+    const listeners = this._listeners === null ? undefined : this._listeners.get(name)
+    if (listeners === undefined) return this
+
+    const i = listeners.findIndex((listener) => listener.fn === fn)
+    if (i !== -1) listeners.splice(i, 1)
+
+    return this
+  }
+
+  _addListener(name, fn, once) {
+    maybeClosed(this)
+
+    if (!this._state._backgroundEvents) {
+      throw new Error('Background events are disabled, open with backgroundEvents: true')
+    }
+
+    if (this._listeners === null) this._listeners = new Map()
+
+    let listeners = this._listeners.get(name)
+    if (listeners === undefined) this._listeners.set(name, (listeners = []))
+
+    listeners.push({ fn, once })
+
+    return this
+  }
+
+  _emitEvent(name, event) {
+    const listeners = this._listeners === null ? undefined : this._listeners.get(name)
+    if (listeners === undefined) return
+
+    for (const listener of listeners.slice()) {
+      if (listener.once) this.off(name, listener.fn)
+      listener.fn.call(this, event)
+    }
   }
 }
 
@@ -248,9 +389,22 @@ module.exports = exports = RocksDB
 
 exports.constants = constants
 
+exports.BlockCache = BlockCache
 exports.ColumnFamily = ColumnFamily
+exports.DropFilter = DropFilter
+exports.Executor = Executor
+exports.ExpiryPolicy = ExpiryPolicy
 exports.BloomFilterPolicy = BloomFilterPolicy
 exports.RibbonFilterPolicy = RibbonFilterPolicy
+exports.RateLimiter = RateLimiter
+exports.Statistics = Statistics
+exports.WriteBufferManager = WriteBufferManager
+
+// The batch behind the single operation methods goes back to the pool before
+// the caller could read its counters
+function maybePerf(opts) {
+  if (opts && opts.perf) throw new Error('Perf counters require a batch from read() or write()')
+}
 
 function maybeClosed(db) {
   if (db._state.closing || db._index === -1) throw new Error('RocksDB session is closed')
@@ -1,18 +1,28 @@
 const c = require('compact-encoding')
 const binding = require('../binding')
+const constants = require('./constants')
+const perf = require('./perf')
 
 const empty = Buffer.alloc(0)
+const noErrors = []
 const resolved = Promise.resolve()
 
 class RocksDBBatch {
   constructor(db, opts = {}) {
-    const { capacity = 8, autoDestroy = false } = opts
+    const {
+      capacity = 8,
+      autoDestroy = false,
+      perf: capturePerf = false,
+      reuse = true
+    } = opts
 
     db._ref()
 
     this._db = db
     this._destroyed = false
     this._capacity = capacity
+    this._perf = capturePerf
+    this._reusable = reuse
     this._operations = []
     this._promises = []
 
@@ -21,25 +31,31 @@ class RocksDBBatch {
     this._request = null
     this._resolve = null
     this._reject = null
+    this._id = 0
 
     this._handle = null
     this._buffer = null
     this._autoDestroy = autoDestroy
     this._stats = null
 
+    this.perf = null
+
     this._resetStats()
 
     if (db._state.opened === true) this.ready()
   }
 
   _reuse(db, opts = {}) {
-    const { autoDestroy = false } = opts
+    const { autoDestroy = false, perf: capturePerf = false } = opts
 
     db._ref()
 
     this._db = db
     this._destroyed = false
     this._autoDestroy = autoDestroy
+    this._perf = capturePerf
+
+    this.perf = null
   }
 
   _onfinished(err) {
@@ -48,6 +64,8 @@ class RocksDBBatch {
 
     if (this._request) this._db._state.io.dec()
 
+    this._untrack()
+
     this._operations = []
     this._promises = []
     this._request = null
@@ -109,6 +127,12 @@ class RocksDBBatch {
 
   _resetStats() {}
 
+  _untrack() {
+    if (this._id === 0) return
+    this._db._state.untrackRequest(this._id)
+    this._id = 0
+  }
+
   async flush() {
     if (this._request) throw new Error('Request in progress')
     if (this._destroyed) throw new Error('Batch is destroyed')
@@ -179,10 +203,49 @@ exports.ReadBatch = class RocksDBReadBatch extends RocksDBBatch {
   constructor(db, opts = {}) {
     super(db, opts)
 
-    const { asyncIO = false, fillCache = true } = opts
+    const {
+      asyncIO = false,
+      fillCache = true,
+      rowCache = true,
+      skipExpired = false,
+      signal = null,
+      timeout = 0,
+      ioTimeout = 0
+    } = opts
 
     this._asyncIO = asyncIO
     this._fillCache = fillCache
+    this._rowCache = rowCache
+    this._skipExpired = skipExpired
+    this._signal = signal
+    this._timeout = timeout
+    this._ioTimeout = ioTimeout
+    this._aborted = false
+
+    this._onabort = this._onabort.bind(this)
+  }
+
+  _reuse(db, opts = {}) {
+    super._reuse(db, opts)
+
+    const {
+      asyncIO = false,
+      fillCache = true,
+      rowCache = true,
+      skipExpired = false,
+      signal = null,
+      timeout = 0,
+      ioTimeout = 0
+    } = opts
+
+    this._asyncIO = asyncIO
+    this._fillCache = fillCache
+    this._rowCache = rowCache
+    this._skipExpired = skipExpired
+    this._signal = signal
+    this._timeout = timeout
+    this._ioTimeout = ioTimeout
+    this._aborted = false
   }
 
   _init() {
@@ -201,6 +264,12 @@ exports.ReadBatch = class RocksDBReadBatch extends RocksDBBatch {
 
     if (this._destroyed) return
 
+    if (this._signal !== null && this._signal.aborted) {
+      return this._oncancel(this._signal.reason)
+    }
+
+    this._id = this._db._state.trackRequest(this)
+
     try {
       binding.read(
         this._db._state._handle,
@@ -209,21 +278,78 @@ exports.ReadBatch = class RocksDBReadBatch extends RocksDBBatch {
         this._db._snapshot ? this._db._snapshot._handle : undefined,
         this._asyncIO,
         this._fillCache,
+        this._rowCache,
+        this._skipExpired,
+        this._perf,
+        this._timeout,
+        this._ioTimeout,
+        this._id,
         this,
         this._onread
       )
     } catch (err) {
+      this._untrack()
       this._db._state.io.dec()
       throw err
     }
 
+    if (this._signal !== null) this._signal.addEventListener('abort', this._onabort)
+
     this._db._state.stats.gets += this._stats.gets
     this._db._state.stats.readBatches++
   }
 
-  _onread(errs, values) {
+  // The request can't be recalled once submitted, so settle its promises now
+  // and let the completion release the batch when RocksDB is done with it.
+  _onabort() {
+    const reason = this._signal.reason
+    const reject = this._reject
+
+    this._aborted = true
+
+    for (let i = 0, n = this._promises.length; i < n; i++) {
+      const promise = this._promises[i]
+      if (promise === null) continue
+
+      this._promises[i] = null
+      promise.reject(reason)
+    }
+
+    this._resolve = null
+    this._reject = null
+
+    if (reject !== null) reject(reason)
+  }
+
+  // An aborted request is settled before RocksDB hands the batch back, so
+  // free it once the completion arrives rather than refusing to.
+  destroy() {
+    if (this._request && this._aborted) {
+      this._autoDestroy = true
+      return
+    }
+
+    super.destroy()
+  }
+
+  _oncancel(reason) {
+    for (let i = 0, n = this._promises.length; i < n; i++) {
+      const promise = this._promises[i]
+      if (promise !== null) promise.reject(reason)
+    }
+
+    this._onfinished(reason)
+  }
+
+  _onread(errs, values, context) {
+    if (this._signal !== null) this._signal.removeEventListener('abort', this._onabort)
+
+    this._aborted = false
+
     let applied = true
 
+    if (context) this.perf = perf.decode(context)
+
     for (let i = 0, n = this._promises.length; i < n; i++) {
       const err = errs[i]
       if (err) applied = false
@@ -238,6 +364,11 @@ exports.ReadBatch = class RocksDBReadBatch extends RocksDBBatch {
     this._onfinished(applied ? null : new AggregateError(errs, 'Batch was not applied'))
   }
 
+  // Batched completions only carry reads that succeeded in full
+  _oncomplete(values) {
+    this._onread(noErrors, values, null)
+  }
+
   _resetStats() {
     this._stats = { gets: 0 }
   }
@@ -257,6 +388,22 @@ exports.ReadBatch = class RocksDBReadBatch extends RocksDBBatch {
 }
 
 exports.WriteBatch = class RocksDBWriteBatch extends RocksDBBatch {
+  constructor(db, opts = {}) {
+    super(db, opts)
+
+    const { failOnPressure = false } = opts
+
+    this._failOnPressure = failOnPressure
+  }
+
+  _reuse(db, opts = {}) {
+    super._reuse(db, opts)
+
+    const { failOnPressure = false } = opts
+
+    this._failOnPressure = failOnPressure
+  }
+
   _init() {
     this._handle = binding.writeInit()
     this._buffer = binding.writeBuffer(this._handle, this._capacity)
@@ -279,9 +426,30 @@ exports.WriteBatch = class RocksDBWriteBatch extends RocksDBBatch {
 
     if (this._destroyed) return
 
+    if (
+      this._failOnPressure &&
+      this._db._state.writePressure !== constants.writeStallCondition.NORMAL
+    ) {
+      const err = new Error('Writes are stalled')
+      err.code = 'EAGAIN'
+      return this._onwrite(err, null)
+    }
+
+    this._id = this._db._state.trackRequest(this)
+
     try {
-      binding.write(this._db._state._handle, this._handle, this._operations, this, this._onwrite)
+      binding.write(
+        this._db._state._handle,
+        this._handle,
+        this._operations,
+        this._perf,
+        this._failOnPressure,
+        this._id,
+        this,
+        this._onwrite
+      )
     } catch (err) {
+      this._untrack()
       this._db._state.io.dec()
       throw err
     }
@@ -292,9 +460,11 @@ exports.WriteBatch = class RocksDBWriteBatch extends RocksDBBatch {
     this._db._state.stats.writeBatches++
   }
 
-  _onwrite(err) {
+  _onwrite(err, context) {
     const applied = !err
 
+    if (context) this.perf = perf.decode(context)
+
     for (let i = 0, n = this._promises.length; i < n; i++) {
       const promise = this._promises[i]
       if (promise === null) continue
@@ -306,6 +476,10 @@ exports.WriteBatch = class RocksDBWriteBatch extends RocksDBBatch {
     this._onfinished(applied ? null : new Error('Batch was not applied', { cause: err }))
   }
 
+  _oncomplete() {
+    this._onwrite(null, null)
+  }
+
   _resetStats() {
     this._stats = { puts: 0, deletes: 0, rangeDeletes: 0 }
   }
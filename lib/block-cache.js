@@ -0,0 +1,74 @@
+const binding = require('../binding')
+const constants = require('./constants')
+
+// Frees the native cache if the wrapper is collected without being destroyed
+const finalizer = new FinalizationRegistry((handle) => binding.blockCacheDestroy(handle))
+
+module.exports = class RocksDBBlockCache {
+  constructor(capacity, opts = {}) {
+    const {
+      type = constants.cacheType.LRU,
+      shardBits = -1,
+      strictCapacityLimit = false
+    } = opts
+
+    this._type = type
+    this._refs = 0
+    this._handle = binding.blockCacheInit(type, capacity, shardBits, strictCapacityLimit)
+
+    finalizer.register(this, this._handle, this)
+  }
+
+  get type() {
+    return this._type
+  }
+
+  get capacity() {
+    maybeDestroyed(this)
+
+    return binding.blockCacheCapacity(this._handle)
+  }
+
+  set capacity(capacity) {
+    maybeDestroyed(this)
+
+    binding.blockCacheSetCapacity(this._handle, capacity)
+  }
+
+  get usage() {
+    maybeDestroyed(this)
+
+    return binding.blockCacheUsage(this._handle)
+  }
+
+  get pinnedUsage() {
+    maybeDestroyed(this)
+
+    return binding.blockCachePinnedUsage(this._handle)
+  }
+
+  _ref() {
+    maybeDestroyed(this)
+
+    this._refs++
+  }
+
+  _unref() {
+    this._refs--
+  }
+
+  destroy() {
+    if (this._handle === null) return
+    if (this._refs > 0) throw new Error('Block cache is in use')
+
+    finalizer.unregister(this)
+
+    binding.blockCacheDestroy(this._handle)
+
+    this._handle = null
+  }
+}
+
+function maybeDestroyed(cache) {
+  if (cache._handle === null) throw new Error('Block cache is destroyed')
+}
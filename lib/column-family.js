@@ -1,7 +1,14 @@
 const binding = require('../binding')
 const constants = require('./constants')
+const BlockCache = require('./block-cache')
 const { BloomFilterPolicy } = require('./filter-policy')
 
+// Matches rocksdb::CompressionOptions::kDefaultCompressionLevel
+const DEFAULT_COMPRESSION_LEVEL = 32767
+
+// Matches rocksdb::kDisableCompressionOption, i.e. inherit the per-level setting
+const INHERIT_COMPRESSION = 0xff
+
 class RocksDBColumnFamily {
   constructor(name, opts = {}) {
     const {
@@ -24,7 +31,31 @@ class RocksDBColumnFamily {
       numLevels = 7,
       maxWriteBufferNumber = 2,
       blobGarbageCollectionAgeCutOff = 0.25,
-      blobGarbageCollectionForceThreshold = 1.0
+      blobGarbageCollectionForceThreshold = 1.0,
+      // Compression options
+      compression = constants.compression.NONE,
+      compressionPerLevel = [],
+      bottommostCompression = null,
+      compressionLevel = DEFAULT_COMPRESSION_LEVEL,
+      compressionMaxDictBytes = 0,
+      compressionZstdMaxTrainBytes = 0,
+      blobCompression = constants.compression.NONE,
+      // Compaction options
+      compactionStyle = constants.compactionStyle.LEVEL,
+      universalSizeRatio = 1,
+      universalMaxMergeWidth = 0xffffffff,
+      fifoMaxTableFilesSize = 1024 * 1024 * 1024,
+      ttl = -1, // Seconds, 0 disables and -1 selects RocksDB's default
+      level0FileNumCompactionTrigger = 4,
+      level0SlowdownWritesTrigger = 20,
+      level0StopWritesTrigger = 36,
+      // Expiry options
+      expiryPolicy = null,
+      dropFilter = null,
+      // Deletion triggered compaction, disabled when the window size is 0
+      compactOnDeletionWindowSize = 0,
+      compactOnDeletionTrigger = 0,
+      compactOnDeletionRatio = 0
     } = opts
 
     this._name = name
@@ -47,7 +78,27 @@ class RocksDBColumnFamily {
       numLevels,
       maxWriteBufferNumber,
       blobGarbageCollectionAgeCutOff,
-      blobGarbageCollectionForceThreshold
+      blobGarbageCollectionForceThreshold,
+      compression,
+      compressionPerLevel,
+      bottommostCompression,
+      compressionLevel,
+      compressionMaxDictBytes,
+      compressionZstdMaxTrainBytes,
+      blobCompression,
+      compactionStyle,
+      universalSizeRatio,
+      universalMaxMergeWidth,
+      fifoMaxTableFilesSize,
+      ttl,
+      level0FileNumCompactionTrigger,
+      level0SlowdownWritesTrigger,
+      level0StopWritesTrigger,
+      expiryPolicy,
+      dropFilter,
+      compactOnDeletionWindowSize,
+      compactOnDeletionTrigger,
+      compactOnDeletionRatio
     }
 
     const filterPolicyArguments = [0, 0, 0]
@@ -86,7 +137,29 @@ class RocksDBColumnFamily {
       numLevels,
       maxWriteBufferNumber,
       blobGarbageCollectionAgeCutOff,
-      blobGarbageCollectionForceThreshold
+      blobGarbageCollectionForceThreshold,
+      blockCache instanceof BlockCache ? blockCache._handle : undefined,
+      compression,
+      new Uint32Array(compressionPerLevel),
+      bottommostCompression === null ? INHERIT_COMPRESSION : bottommostCompression,
+      compressionLevel,
+      compressionMaxDictBytes,
+      compressionZstdMaxTrainBytes,
+      blobCompression,
+      compactionStyle,
+      universalSizeRatio,
+      universalMaxMergeWidth,
+      fifoMaxTableFilesSize,
+      ttl,
+      expiryPolicy === null ? 0 : expiryPolicy.field,
+      expiryPolicy === null ? 0 : expiryPolicy.width,
+      dropFilter === null ? undefined : dropFilter._handle,
+      compactOnDeletionWindowSize,
+      compactOnDeletionTrigger,
+      compactOnDeletionRatio,
+      level0FileNumCompactionTrigger,
+      level0SlowdownWritesTrigger,
+      level0StopWritesTrigger
     )
   }
 
@@ -31,5 +31,48 @@ module.exports = {
   walFileType: {
     ARCHIVED: 0,
     ALIVE: 1
+  },
+  compactionStyle: {
+    LEVEL: 0,
+    UNIVERSAL: 1,
+    FIFO: 2
+  },
+  compression: {
+    NONE: 0,
+    LZ4: 4,
+    LZ4HC: 5,
+    ZSTD: 7
+  },
+  expiryField: {
+    VALUE_PREFIX: 1,
+    VALUE_SUFFIX: 2,
+    KEY_SUFFIX: 3
+  },
+  cacheType: {
+    LRU: 0,
+    HYPER_CLOCK: 1
+  },
+  rateLimiterMode: {
+    READS_ONLY: 0,
+    WRITES_ONLY: 1,
+    ALL_IO: 2
+  },
+  ioPriority: {
+    LOW: 0,
+    MID: 1,
+    HIGH: 2,
+    USER: 3,
+    TOTAL: 4
+  },
+  writeStallCondition: {
+    NORMAL: 0,
+    DELAYED: 1,
+    STOPPED: 2
+  },
+  executorLane: {
+    READ: 0,
+    WRITE: 1,
+    SCAN: 2,
+    MAINTENANCE: 3
   }
 }
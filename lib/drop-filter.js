@@ -0,0 +1,71 @@
+const binding = require('../binding')
+
+// Prefixes and range bounds are matched against the raw keys stored in
+// RocksDB. A filter may be shared by databases with different key encodings,
+// so it never applies one: pass strings, which are UTF-8 encoded, or buffers
+// holding the already encoded bytes.
+// Frees the native filter if the wrapper is collected without being destroyed
+const finalizer = new FinalizationRegistry((handle) => binding.dropFilterDestroy(handle))
+
+module.exports = class RocksDBDropFilter {
+  constructor(opts = {}) {
+    this._refs = 0
+    this._handle = binding.dropFilterInit()
+    this._prefixes = []
+    this._ranges = []
+
+    finalizer.register(this, this._handle, this)
+
+    this.update(opts)
+  }
+
+  get prefixes() {
+    return this._prefixes
+  }
+
+  get ranges() {
+    return this._ranges
+  }
+
+  update(opts = {}) {
+    if (this._handle === null) throw new Error('Drop filter is destroyed')
+
+    const { prefixes = [], ranges = [] } = opts
+
+    this._prefixes = prefixes.map(encodeKey)
+    this._ranges = ranges.map(({ start, end }) => ({ start: encodeKey(start), end: encodeKey(end) }))
+
+    binding.dropFilterUpdate(
+      this._handle,
+      this._prefixes,
+      this._ranges.map((range) => range.start),
+      this._ranges.map((range) => range.end)
+    )
+  }
+
+  _ref() {
+    if (this._handle === null) throw new Error('Drop filter is destroyed')
+
+    this._refs++
+  }
+
+  _unref() {
+    this._refs--
+  }
+
+  destroy() {
+    if (this._handle === null) return
+    if (this._refs > 0) throw new Error('Drop filter is in use')
+
+    finalizer.unregister(this)
+
+    binding.dropFilterDestroy(this._handle)
+
+    this._handle = null
+  }
+}
+
+function encodeKey(key) {
+  if (typeof key === 'string') return Buffer.from(key)
+  return key
+}
@@ -0,0 +1,48 @@
+const binding = require('../binding')
+const constants = require('./constants')
+
+// Stops the workers if the wrapper is collected without being destroyed. A
+// database holds on to its executor while open, so nothing is pending then.
+const finalizer = new FinalizationRegistry((handle) => binding.executorDestroy(handle))
+
+module.exports = class RocksDBExecutor {
+  constructor(opts = {}) {
+    const { reads = 4, writes = 2, scans = 2, maintenance = 1 } = opts
+
+    this._refs = 0
+    this._handle = binding.executorInit(reads, writes, scans, maintenance)
+
+    finalizer.register(this, this._handle, this)
+  }
+
+  pending(lane = constants.executorLane.READ) {
+    maybeDestroyed(this)
+
+    return binding.executorPending(this._handle, lane)
+  }
+
+  _ref() {
+    maybeDestroyed(this)
+
+    this._refs++
+  }
+
+  _unref() {
+    this._refs--
+  }
+
+  destroy() {
+    if (this._handle === null) return
+    if (this._refs > 0) throw new Error('Executor is in use')
+
+    finalizer.unregister(this)
+
+    binding.executorDestroy(this._handle)
+
+    this._handle = null
+  }
+}
+
+function maybeDestroyed(executor) {
+  if (executor._handle === null) throw new Error('Executor is destroyed')
+}
@@ -0,0 +1,25 @@
+const constants = require('./constants')
+
+// Expiry timestamps are big-endian unsigned integers holding seconds since
+// the Unix epoch, where 0 means that the entry never expires.
+module.exports = class RocksDBExpiryPolicy {
+  constructor(opts = {}) {
+    const { field = constants.expiryField.VALUE_PREFIX, width = 8 } = opts
+
+    if (width !== 4 && width !== 8) throw new Error('Expiry width must be 4 or 8 bytes')
+
+    this.field = field
+    this.width = width
+  }
+
+  encode(buffer, expiresAt) {
+    const timestamp = Buffer.alloc(this.width)
+
+    if (this.width === 4) timestamp.writeUInt32BE(expiresAt)
+    else timestamp.writeBigUInt64BE(BigInt(expiresAt))
+
+    return this.field === constants.expiryField.VALUE_PREFIX
+      ? Buffer.concat([timestamp, buffer])
+      : Buffer.concat([buffer, timestamp])
+  }
+}
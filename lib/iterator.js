@@ -1,6 +1,7 @@
 const { Readable } = require('streamx')
 const c = require('compact-encoding')
 const binding = require('../binding')
+const perf = require('./perf')
 
 const empty = Buffer.alloc(0)
 
@@ -14,7 +15,12 @@ module.exports = class RocksDBIterator extends Readable {
       reverse = false,
       values = true,
       limit = Infinity,
-      capacity = 8
+      capacity = 8,
+      skipExpired = false,
+      perf: capturePerf = false,
+      signal = null,
+      timeout = 0,
+      ioTimeout = 0
     } = opts
 
     super()
@@ -32,6 +38,11 @@ module.exports = class RocksDBIterator extends Readable {
     this._values = values
     this._limit = limit < 0 ? Infinity : limit
     this._capacity = capacity
+    this._skipExpired = skipExpired
+    this._perf = capturePerf
+    this._signal = signal
+    this._timeout = timeout
+    this._ioTimeout = ioTimeout
     this._opened = false
 
     this._pendingOpen = null
@@ -41,9 +52,22 @@ module.exports = class RocksDBIterator extends Readable {
     this._buffer = null
     this._handle = null
 
+    this.perf = null
+
+    if (signal !== null) {
+      this._onabort = this._onabort.bind(this)
+
+      if (signal.aborted) this.destroy(signal.reason)
+      else signal.addEventListener('abort', this._onabort)
+    }
+
     if (this._db._state.opened === true) this.ready()
   }
 
+  _onabort() {
+    this.destroy(this._signal.reason)
+  }
+
   _onopen(err) {
     const cb = this._pendingOpen
     this._pendingOpen = null
@@ -52,10 +76,16 @@ module.exports = class RocksDBIterator extends Readable {
     cb(err)
   }
 
-  _onread(err, keys, values) {
+  _onread(err, keys, values, context) {
     const cb = this._pendingRead
     this._pendingRead = null
     this._db._state.io.dec()
+
+    if (context) {
+      const counters = perf.decode(context)
+      this.perf = this.perf === null ? counters : perf.add(this.perf, counters)
+    }
+
     if (err) return cb(err)
 
     const n = keys.length
@@ -75,6 +105,8 @@ module.exports = class RocksDBIterator extends Readable {
   }
 
   _onclose(err) {
+    if (this._signal !== null) this._signal.removeEventListener('abort', this._onabort)
+
     const cb = this._pendingDestroy
     this._pendingDestroy = null
     this._db._state.io.dec()
@@ -129,6 +161,10 @@ module.exports = class RocksDBIterator extends Readable {
         this._lte,
         this._reverse,
         !this._values, // Keys only
+        this._skipExpired,
+        this._perf,
+        this._timeout,
+        this._ioTimeout,
         this._db._snapshot ? this._db._snapshot._handle : undefined,
         this,
         this._onopen,
@@ -172,6 +208,8 @@ module.exports = class RocksDBIterator extends Readable {
     this._db._state.io.inc()
 
     if (this._opened === false) {
+      if (this._signal !== null) this._signal.removeEventListener('abort', this._onabort)
+
       this._db._state.io.dec()
       this._db._unref()
 
@@ -0,0 +1,23 @@
+const binding = require('../binding')
+
+// The binding copies each counter out of the perf context by name and
+// exports the order it writes them in. Counters are plain counts or bytes
+// and timers are in nanoseconds.
+const fields = binding.PERF_FIELDS
+
+exports.decode = function decode(buffer) {
+  const data = new BigUint64Array(buffer, 0, fields.length)
+  const result = {}
+
+  for (let i = 0; i < fields.length; i++) result[fields[i]] = Number(data[i])
+
+  return result
+}
+
+exports.add = function add(a, b) {
+  const result = {}
+
+  for (const field of fields) result[field] = a[field] + b[field]
+
+  return result
+}
@@ -0,0 +1,80 @@
+const binding = require('../binding')
+const constants = require('./constants')
+
+// Frees the native limiter if the wrapper is collected without being destroyed
+const finalizer = new FinalizationRegistry((handle) => binding.rateLimiterDestroy(handle))
+
+module.exports = class RocksDBRateLimiter {
+  constructor(bytesPerSecond, opts = {}) {
+    const {
+      refillPeriod = 100000, // Microseconds
+      fairness = 10,
+      mode = constants.rateLimiterMode.WRITES_ONLY,
+      autoTuned = false
+    } = opts
+
+    this._mode = mode
+    this._autoTuned = autoTuned
+    this._refs = 0
+    this._handle = binding.rateLimiterInit(bytesPerSecond, refillPeriod, fairness, mode, autoTuned)
+
+    finalizer.register(this, this._handle, this)
+  }
+
+  get mode() {
+    return this._mode
+  }
+
+  get autoTuned() {
+    return this._autoTuned
+  }
+
+  get bytesPerSecond() {
+    maybeDestroyed(this)
+
+    return binding.rateLimiterBytesPerSecond(this._handle)
+  }
+
+  setBytesPerSecond(bytesPerSecond) {
+    maybeDestroyed(this)
+
+    binding.rateLimiterSetBytesPerSecond(this._handle, bytesPerSecond)
+  }
+
+  totalBytesThrough(priority = constants.ioPriority.TOTAL) {
+    maybeDestroyed(this)
+
+    return binding.rateLimiterTotalBytesThrough(this._handle, priority)
+  }
+
+  totalRequests(priority = constants.ioPriority.TOTAL) {
+    maybeDestroyed(this)
+
+    return binding.rateLimiterTotalRequests(this._handle, priority)
+  }
+
+  _ref() {
+    maybeDestroyed(this)
+
+    this._refs++
+  }
+
+  _unref() {
+    this._refs--
+  }
+
+  destroy() {
+    if (this._handle === null) return
+    if (this._refs > 0) throw new Error('Rate limiter is in use')
+
+    finalizer.unregister(this)
+
+    binding.rateLimiterDestroy(this._handle)
+
+    this._handle = null
+  }
+}
+
+function maybeDestroyed(limiter) {
+  if (limiter._handle === null) throw new Error('Rate limiter is destroyed')
+}
@@ -5,12 +5,21 @@ const SignalPromise = require('signal-promise')
 const c = require('compact-encoding')
 const { ReadBatch, WriteBatch } = require('./batch')
 const ColumnFamily = require('./column-family')
+const BlockCache = require('./block-cache')
 const binding = require('../binding')
 const constants = require('./constants')
 
 const MAX_BATCH_REUSE = 64
+const LATENCY_OPS = ['read', 'write', 'iteratorRead', 'flush', 'compact']
+const LATENCY_PHASES = ['queue', 'engine', 'total']
+const LATENCY_FIELDS = ['count', 'min', 'max', 'mean', 'p50', 'p90', 'p99', 'p999']
+const REPLAY_OPS = ['get', 'write', 'seek', 'multiGet']
+const DEFAULT_TRACE_SIZE = 64 * 1024 * 1024 * 1024
 const empty = Buffer.alloc(0)
 
+// Written by the binding for memory properties that couldn't be read
+const UNAVAILABLE = 0xffffffffffffffffn
+
 module.exports = class RocksDBState extends ReadyResource {
   constructor(db, path, opts) {
     super()
@@ -37,7 +46,15 @@ module.exports = class RocksDBState extends ReadyResource {
       walTtlSeconds = 0,
       walSizeLimitMegabytes = 0,
       avoidFlushDuringShutdown = false,
-      walFilterPrefixes = []
+      walFilterPrefixes = [],
+      writeBufferManager = null,
+      rateLimiter = null,
+      executor = null,
+      rowCache = null,
+      batchCompletions = false,
+      // Bridges RocksDB background events to on() and keeps writePressure
+      // current. Without it stalled writes still fail natively on pressure.
+      backgroundEvents = false
     } = opts
 
     this.path = path
@@ -48,13 +65,17 @@ module.exports = class RocksDBState extends ReadyResource {
     this.columnFamilies = [columnFamily]
     this.deferSnapshotInit = true
     this.resumed = null
+    this.writePressure = constants.writeStallCondition.NORMAL
     this.stats = {
       gets: 0,
       puts: 0,
       deletes: 0,
       rangeDeletes: 0,
       readBatches: 0,
-      writeBatches: 0
+      writeBatches: 0,
+      rowCacheHits: 0,
+      rowCacheMisses: 0,
+      reusedBatches: 0
     }
 
     this._suspended = false
@@ -63,6 +84,16 @@ module.exports = class RocksDBState extends ReadyResource {
     this._updatingSignal = new SignalPromise()
     this._columnsFlushed = false
     this._lock = lock
+    this._writeBufferManager = writeBufferManager
+    this._rateLimiter = rateLimiter
+    this._executor = executor
+    this._enableStatistics = enableStatistics
+    this._stalls = new Map()
+    this._resources = []
+    this._batchCompletions = batchCompletions
+    this._backgroundEvents = backgroundEvents
+    this._inflight = new Map()
+    this._nextRequestId = 1
     this._readBatches = []
     this._writeBatches = []
 
@@ -91,26 +122,32 @@ module.exports = class RocksDBState extends ReadyResource {
       walTtlSeconds,
       walSizeLimitMegabytes,
       avoidFlushDuringShutdown,
-      walFilterPrefixes.map(encodePrefix)
+      walFilterPrefixes.map(encodePrefix),
+      writeBufferManager === null ? undefined : writeBufferManager._handle,
+      rateLimiter === null ? undefined : rateLimiter._handle,
+      rowCache === null ? 0 : rowCache.capacity,
+      executor === null ? undefined : executor._handle
     )
   }
 
   createReadBatch(db, opts) {
-    if (this._readBatches.length === 0) return new ReadBatch(db, opts)
+    if (this._readBatches.length === 0 || !reusable(opts)) return new ReadBatch(db, opts)
     const batch = this._readBatches.pop()
     batch._reuse(db, opts)
+    this.stats.reusedBatches++
     return batch
   }
 
   createWriteBatch(db, opts) {
-    if (this._writeBatches.length === 0) return new WriteBatch(db, opts)
+    if (this._writeBatches.length === 0 || !reusable(opts)) return new WriteBatch(db, opts)
     const batch = this._writeBatches.pop()
     batch._reuse(db, opts)
+    this.stats.reusedBatches++
     return batch
   }
 
   freeBatch(batch, writable) {
-    if (batch._capacity > 16) return
+    if (batch._reusable === false || batch._capacity > 16) return
     const queue = writable ? this._writeBatches : this._readBatches
     if (queue.length >= MAX_BATCH_REUSE) return
     queue.push(batch)
@@ -174,19 +211,30 @@ module.exports = class RocksDBState extends ReadyResource {
 
     this._columnsFlushed = true
 
+    this._acquireResources()
+
     const lock = this._lock === null ? -1 : this._lock.transfer()
 
-    req.handle = binding.open(
-      this._handle,
-      this,
-      this.path,
-      this.columnFamilies.map((c) => c._handle),
-      lock,
-      req,
-      onopen
-    )
+    try {
+      req.handle = binding.open(
+        this._handle,
+        this,
+        this.path,
+        this.columnFamilies.map((c) => c._handle),
+        lock,
+        req,
+        onopen,
+        this._backgroundEvents,
+        this._onevents,
+        this._batchCompletions,
+        this._oncompletions
+      )
 
-    await promise
+      await promise
+    } catch (err) {
+      this._releaseResources()
+      throw err
+    }
 
     this.deferSnapshotInit = false
 
@@ -200,6 +248,36 @@ module.exports = class RocksDBState extends ReadyResource {
     }
   }
 
+  // Shared native objects are referenced from the database until the native
+  // close has finished, so hold on to them for as long as it's open.
+  _acquireResources() {
+    try {
+      if (this._executor !== null) this._acquire(this._executor)
+      if (this._writeBufferManager !== null) this._acquire(this._writeBufferManager)
+      if (this._rateLimiter !== null) this._acquire(this._rateLimiter)
+
+      for (const columnFamily of this.columnFamilies) {
+        const { blockCache, dropFilter } = columnFamily._options
+
+        if (blockCache instanceof BlockCache) this._acquire(blockCache)
+        if (dropFilter !== null) this._acquire(dropFilter)
+      }
+    } catch (err) {
+      this._releaseResources()
+      throw err
+    }
+  }
+
+  _acquire(resource) {
+    resource._ref()
+    this._resources.push(resource)
+  }
+
+  _releaseResources() {
+    for (const resource of this._resources) resource._unref()
+    this._resources = []
+  }
+
   async _close() {
     while (this._updating) await this._updatingSignal.wait()
     if (this.resumed) this.resumed.resolve(false)
@@ -225,6 +303,8 @@ module.exports = class RocksDBState extends ReadyResource {
     try {
       await promise
     } finally {
+      this._releaseResources()
+
       if (this._lock) await this._lock.close()
     }
 
@@ -362,13 +442,16 @@ module.exports = class RocksDBState extends ReadyResource {
   async compact(db, opts) {
     if (this.opened === false) await this.ready()
 
+    if (opts.signal && opts.signal.aborted) throw opts.signal.reason
+
     this.io.inc()
 
     const {
       exclusive = false,
       blobGarbageCollectionPolicy = constants.garbageCollectionPolicy.DEFAULT,
       blobGarbageCollectionAgeCutoff = 0.25,
-      bottommostLevelCompaction = constants.bottommostLevelCompaction.NONE
+      bottommostLevelCompaction = constants.bottommostLevelCompaction.NONE,
+      signal = null
     } = opts
 
     const req = { resolve: null, reject: null, handle: null }
@@ -390,13 +473,21 @@ module.exports = class RocksDBState extends ReadyResource {
         oncompact
       )
 
+      if (signal !== null) signal.addEventListener('abort', onabort)
+
       await promise
     } finally {
+      if (signal !== null) signal.removeEventListener('abort', onabort)
+
       this.io.dec()
     }
 
+    function onabort() {
+      binding.compactCancel(req.handle)
+    }
+
     function oncompact(err) {
-      if (err) req.reject(err)
+      if (err) req.reject(err.code === 'ECANCELED' && signal !== null ? signal.reason : err)
       else req.resolve()
     }
   }
@@ -404,13 +495,16 @@ module.exports = class RocksDBState extends ReadyResource {
   async compactRange(db, start, end, opts) {
     if (this.opened === false) await this.ready()
 
+    if (opts.signal && opts.signal.aborted) throw opts.signal.reason
+
     this.io.inc()
 
     const {
       exclusive = false,
       blobGarbageCollectionPolicy = constants.garbageCollectionPolicy.DEFAULT,
       blobGarbageCollectionAgeCutoff = 0.25,
-      bottommostLevelCompaction = constants.bottommostLevelCompaction.NONE
+      bottommostLevelCompaction = constants.bottommostLevelCompaction.NONE,
+      signal = null
     } = opts
 
     start = this._encodeKey(start)
@@ -437,13 +531,21 @@ module.exports = class RocksDBState extends ReadyResource {
         oncompactrange
       )
 
+      if (signal !== null) signal.addEventListener('abort', onabort)
+
       await promise
     } finally {
+      if (signal !== null) signal.removeEventListener('abort', onabort)
+
       this.io.dec()
     }
 
+    function onabort() {
+      binding.compactRangeCancel(req.handle)
+    }
+
     function oncompactrange(err) {
-      if (err) req.reject(err)
+      if (err) req.reject(err.code === 'ECANCELED' && signal !== null ? signal.reason : err)
       else req.resolve()
     }
   }
@@ -489,6 +591,80 @@ module.exports = class RocksDBState extends ReadyResource {
     }
   }
 
+  async keyMayExist(db, keys, opts) {
+    if (this.opened === false) await this.ready()
+
+    this.io.inc()
+
+    const { confirm = false } = opts
+
+    keys = keys.map((key) => this._encodeKey(key))
+
+    const bitmap = new Uint8Array(Math.ceil(keys.length / 8))
+
+    const req = { resolve: null, reject: null, handle: null, keys }
+
+    const promise = new Promise((resolve, reject) => {
+      req.resolve = resolve
+      req.reject = reject
+    })
+
+    try {
+      req.handle = binding.keyMayExist(
+        this._handle,
+        db._columnFamily._handle,
+        keys,
+        bitmap,
+        confirm,
+        db._snapshot ? db._snapshot._handle : undefined,
+        req,
+        onkeymayexist
+      )
+
+      await promise
+    } finally {
+      this.io.dec()
+    }
+
+    return bitmap
+
+    function onkeymayexist(err) {
+      if (err) req.reject(err)
+      else req.resolve()
+    }
+  }
+
+  async tableProperties(db) {
+    if (this.opened === false) await this.ready()
+
+    this.io.inc()
+
+    const req = { resolve: null, reject: null, handle: null }
+
+    const promise = new Promise((resolve, reject) => {
+      req.resolve = resolve
+      req.reject = reject
+    })
+
+    try {
+      req.handle = binding.tableProperties(
+        this._handle,
+        db._columnFamily._handle,
+        req,
+        ontableproperties
+      )
+
+      return await promise
+    } finally {
+      this.io.dec()
+    }
+
+    function ontableproperties(err, files) {
+      if (err) req.reject(err)
+      else req.resolve(files)
+    }
+  }
+
   async currentWalFile() {
     if (this.opened === false) await this.ready()
 
@@ -527,6 +703,217 @@ module.exports = class RocksDBState extends ReadyResource {
     binding.statsLevelSet(this._handle, level)
   }
 
+  updateTickerStats() {
+    if (this._enableStatistics === false || this.opened === false || this.closing) return
+
+    this.stats.rowCacheHits = binding.tickerGet(this._handle, binding.ROW_CACHE_HIT)
+    this.stats.rowCacheMisses = binding.tickerGet(this._handle, binding.ROW_CACHE_MISS)
+  }
+
+  // Registers a batch for delivery through _oncompletions, returning the id to
+  // hand to the binding or 0 if completions are delivered per request.
+  trackRequest(batch) {
+    if (this._batchCompletions === false) return 0
+
+    const id = this._nextRequestId
+
+    this._nextRequestId = id === 0xffffffff ? 1 : id + 1
+    this._inflight.set(id, batch)
+
+    return id
+  }
+
+  untrackRequest(id) {
+    this._inflight.delete(id)
+  }
+
+  _oncompletions(ids, results) {
+    ids = new Uint32Array(ids)
+
+    for (let i = 0; i < ids.length; i++) {
+      const batch = this._inflight.get(ids[i])
+      if (batch !== undefined) batch._oncomplete(results[i])
+    }
+  }
+
+  _onevents(events) {
+    for (const event of events) {
+      if (event.type === 'stall') this._onstall(event)
+
+      if (event.type === 'background-error') this._emitEvent('background-error', event.error)
+      else this._emitEvent(event.type, event)
+    }
+  }
+
+  // Listeners belong to the sessions, so they go away when a session closes
+  _emitEvent(name, event) {
+    for (const session of this.sessions.slice()) session._emitEvent(name, event)
+  }
+
+  // The database is under as much pressure as its most stalled column family
+  _onstall(event) {
+    if (event.current === constants.writeStallCondition.NORMAL) {
+      this._stalls.delete(event.columnFamily)
+    } else {
+      this._stalls.set(event.columnFamily, event.current)
+    }
+
+    let pressure = constants.writeStallCondition.NORMAL
+
+    for (const condition of this._stalls.values()) {
+      if (condition > pressure) pressure = condition
+    }
+
+    if (pressure === this.writePressure) return
+
+    const previous = this.writePressure
+
+    this.writePressure = pressure
+
+    // Report the numbers of the column family that changed condition
+    const columnFamily = this.getColumnFamilyByName(event.columnFamily)
+
+    this._emitEvent('pressure', {
+      pressure,
+      previous,
+      columnFamily: event.columnFamily,
+      pendingCompactionBytes: this._integerProperty(
+        columnFamily,
+        'rocksdb.estimate-pending-compaction-bytes'
+      ),
+      level0Files: this._integerProperty(columnFamily, 'rocksdb.num-files-at-level0'),
+      immutableMemtables: this._integerProperty(columnFamily, 'rocksdb.num-immutable-mem-table')
+    })
+  }
+
+  _integerProperty(columnFamily, name) {
+    if (this.opened === false || this.closing || columnFamily === null) return 0
+
+    const value = binding.propertyGetInt(this._handle, columnFamily._handle, name)
+
+    return value == null ? 0 : Number(value)
+  }
+
+  async statistics(result) {
+    if (this.opened === false) await this.ready()
+
+    binding.statistics(this._handle, result.tickers, result.histograms)
+
+    return result
+  }
+
+  // Column families sharing a block cache each report its full usage, so the
+  // totals use the approximate usage by type which counts every cache once.
+  async memoryUsage() {
+    if (this.opened === false) await this.ready()
+
+    const usage = new BigUint64Array(7)
+    const total = new BigUint64Array(4)
+
+    const columnFamilies = {}
+
+    // Bytes held by iterators, both in memtables that were flushed or
+    // replaced and in block cache entries, counting each cache once
+    const pinnedCaches = new Map()
+
+    for (const columnFamily of this.columnFamilies) {
+      binding.memoryUsage(this._handle, columnFamily._handle, usage)
+
+      const [active, unflushed, all, tableReaders, blockCache, blockCachePinned, blobCache] =
+        Array.from(usage, (value) => (value === UNAVAILABLE ? null : Number(value)))
+
+      const memtablePinned = difference(all, unflushed)
+
+      columnFamilies[columnFamily.name] = {
+        memtable: { active, immutable: difference(unflushed, active), pinned: memtablePinned },
+        tableReaders,
+        blockCache: { usage: blockCache, pinned: blockCachePinned },
+        blobCache,
+        iteratorPinned: sum(memtablePinned, blockCachePinned)
+      }
+
+      const { blockCache: cache } = columnFamily._options
+
+      pinnedCaches.set(cache instanceof BlockCache ? cache : columnFamily, blockCachePinned)
+    }
+
+    binding.approximateMemoryUsage(this._handle, total)
+
+    const [memtables, unflushed, tableReaders, caches] = Array.from(total, Number)
+
+    let iteratorPinned = memtables - unflushed
+
+    for (const pinned of pinnedCaches.values()) iteratorPinned += pinned || 0
+
+    return {
+      total: memtables + tableReaders + caches,
+      memtable: { total: memtables, unflushed, pinned: memtables - unflushed },
+      tableReaders,
+      cache: caches,
+      iteratorPinned,
+      columnFamilies
+    }
+  }
+
+  // Traces one in every `sampling` requests until the file reaches `maxSize`
+  async startTrace(path, opts = {}) {
+    if (this.opened === false) await this.ready()
+
+    const { sampling = 1, maxSize = DEFAULT_TRACE_SIZE, blockCache = false } = opts
+
+    if (blockCache) binding.blockCacheTraceStart(this._handle, path, sampling, maxSize)
+    else binding.traceStart(this._handle, path, sampling, maxSize)
+  }
+
+  async endTrace(opts = {}) {
+    if (this.opened === false) await this.ready()
+
+    const { blockCache = false } = opts
+
+    if (blockCache) binding.blockCacheTraceEnd(this._handle)
+    else binding.traceEnd(this._handle)
+  }
+
+  async replayTrace(path, opts = {}) {
+    if (this.opened === false) await this.ready()
+
+    const { speedup = 1, concurrency = 1 } = opts
+
+    this.io.inc()
+
+    const req = { resolve: null, reject: null, handle: null }
+
+    const promise = new Promise((resolve, reject) => {
+      req.resolve = resolve
+      req.reject = reject
+    })
+
+    try {
+      req.handle = binding.replay(this._handle, path, speedup, concurrency, req, onreplay)
+
+      return await promise
+    } finally {
+      this.io.dec()
+    }
+
+    function onreplay(err, latency) {
+      if (err) return req.reject(err)
+
+      const data = new Float64Array(latency)
+      const result = {}
+
+      for (let i = 0; i < REPLAY_OPS.length; i++) {
+        const histogram = (result[REPLAY_OPS[i]] = {})
+
+        for (let j = 0; j < LATENCY_FIELDS.length; j++) {
+          histogram[LATENCY_FIELDS[j]] = data[i * LATENCY_FIELDS.length + j]
+        }
+      }
+
+      req.resolve(result)
+    }
+  }
+
   async getProperty(name) {
     if (this.opened === false) await this.ready()
 
@@ -540,8 +927,8 @@ module.exports = class RocksDBState extends ReadyResource {
     return k
   }
 
-  diagnostics() {
-    return {
+  diagnostics({ latency = false } = {}) {
+    const result = {
       suspended: this._suspended,
       suspending: this._suspending,
       updating: this._updating,
@@ -550,6 +937,40 @@ module.exports = class RocksDBState extends ReadyResource {
       handles: this.handles.count,
       sessions: this.sessions.length
     }
+
+    if (latency) result.latency = this.latency()
+
+    return result
+  }
+
+  // Latencies are in microseconds, split into the time spent queued for a
+  // worker thread, the time spent in RocksDB and the total round trip.
+  latency() {
+    const data = new Float64Array(
+      LATENCY_OPS.length * LATENCY_PHASES.length * LATENCY_FIELDS.length
+    )
+
+    binding.latency(this._handle, data)
+
+    const result = {}
+
+    let offset = 0
+
+    for (const op of LATENCY_OPS) {
+      result[op] = {}
+
+      for (const phase of LATENCY_PHASES) {
+        const histogram = (result[op][phase] = {})
+
+        for (const field of LATENCY_FIELDS) histogram[field] = data[offset++]
+      }
+    }
+
+    return result
+  }
+
+  resetLatency() {
+    binding.latencyReset(this._handle)
   }
 }
 
@@ -557,3 +978,16 @@ function encodePrefix(prefix) {
   if (typeof prefix === 'string') return Buffer.from(prefix)
   return prefix
 }
+
+// Batches created with `reuse: false` neither come from nor return to the pool
+function reusable(opts) {
+  return !opts || opts.reuse !== false
+}
+
+function difference(a, b) {
+  return a === null || b === null ? null : a - b
+}
+
+function sum(a, b) {
+  return a === null || b === null ? null : a + b
+}
@@ -0,0 +1,50 @@
+const binding = require('../binding')
+
+const HISTOGRAM_FIELDS = 6 // p50, p95, p99, max, count, sum
+
+const tickers = indexNames(binding.TICKERS)
+const histograms = indexNames(binding.HISTOGRAMS)
+
+module.exports = class RocksDBStatistics {
+  constructor() {
+    this.tickers = new BigUint64Array(binding.TICKERS.length)
+    this.histograms = new Float64Array(binding.HISTOGRAMS.length * HISTOGRAM_FIELDS)
+  }
+
+  static get tickers() {
+    return tickers
+  }
+
+  static get histograms() {
+    return histograms
+  }
+
+  ticker(name) {
+    const index = tickers[name]
+    if (index === undefined) throw new Error('Unknown ticker')
+
+    return Number(this.tickers[index])
+  }
+
+  histogram(name) {
+    const index = histograms[name]
+    if (index === undefined) throw new Error('Unknown histogram')
+
+    const offset = index * HISTOGRAM_FIELDS
+
+    return {
+      p50: this.histograms[offset],
+      p95: this.histograms[offset + 1],
+      p99: this.histograms[offset + 2],
+      max: this.histograms[offset + 3],
+      count: this.histograms[offset + 4],
+      sum: this.histograms[offset + 5]
+    }
+  }
+}
+
+function indexNames(names) {
+  const index = Object.create(null)
+  for (let i = 0; i < names.length; i++) index[names[i]] = i
+  return Object.freeze(index)
+}
@@ -0,0 +1,83 @@
+const binding = require('../binding')
+
+// Frees the native manager if the wrapper is collected without being destroyed
+const finalizer = new FinalizationRegistry(({ handle, blockCache }) => {
+  binding.writeBufferManagerDestroy(handle)
+
+  if (blockCache !== null) blockCache._unref()
+})
+
+module.exports = class RocksDBWriteBufferManager {
+  constructor(bufferSize, opts = {}) {
+    const { blockCache = null, allowStall = false } = opts
+
+    // The manager charges memtables to the cache for as long as it lives
+    if (blockCache !== null) blockCache._ref()
+
+    this._blockCache = blockCache
+    this._allowStall = allowStall
+    this._refs = 0
+    this._handle = binding.writeBufferManagerInit(
+      bufferSize,
+      blockCache === null ? undefined : blockCache._handle,
+      allowStall
+    )
+
+    finalizer.register(this, { handle: this._handle, blockCache }, this)
+  }
+
+  get allowStall() {
+    return this._allowStall
+  }
+
+  get bufferSize() {
+    maybeDestroyed(this)
+
+    return binding.writeBufferManagerBufferSize(this._handle)
+  }
+
+  set bufferSize(bufferSize) {
+    maybeDestroyed(this)
+
+    binding.writeBufferManagerSetBufferSize(this._handle, bufferSize)
+  }
+
+  get memoryUsage() {
+    maybeDestroyed(this)
+
+    return binding.writeBufferManagerMemoryUsage(this._handle)
+  }
+
+  get stalled() {
+    maybeDestroyed(this)
+
+    return binding.writeBufferManagerStalled(this._handle)
+  }
+
+  _ref() {
+    maybeDestroyed(this)
+
+    this._refs++
+  }
+
+  _unref() {
+    this._refs--
+  }
+
+  destroy() {
+    if (this._handle === null) return
+    if (this._refs > 0) throw new Error('Write buffer manager is in use')
+
+    finalizer.unregister(this)
+
+    binding.writeBufferManagerDestroy(this._handle)
+
+    this._handle = null
+
+    if (this._blockCache !== null) this._blockCache._unref()
+  }
+}
+
+function maybeDestroyed(manager) {
+  if (manager._handle === null) throw new Error('Write buffer manager is destroyed')
+}
@@ -1343,6 +1343,29 @@ test('stats', async (t) => {
   await db.close()
 })
 
+test('batch reuse', async (t) => {
+  const db = new RocksDB(await t.tmp())
+  await db.ready()
+
+  db.write().destroy()
+
+  const reused = db.write()
+  t.is(db.stats.reusedBatches, 1)
+  reused.destroy()
+
+  const fresh = db.write({ reuse: false })
+  t.is(db.stats.reusedBatches, 1, 'fresh batch skips the pool')
+  fresh.destroy()
+
+  const a = db.write()
+  const b = db.write()
+  t.is(db.stats.reusedBatches, 2, 'fresh batch was not returned to the pool')
+  a.destroy()
+  b.destroy()
+
+  await db.close()
+})
+
 test('getProperty', async (t) => {
   const db = new RocksDB(await t.tmp())
   await db.ready()
@@ -1571,4 +1594,1135 @@ test('WAL database options', async (t) => {
   await db.close()
 })
 
+test('shared block cache', async (t) => {
+  const cache = new RocksDB.BlockCache(8 * 1024 * 1024)
+  t.teardown(() => cache.destroy())
+
+  const a = new RocksDB(await t.tmp(), { blockCache: cache })
+  const b = new RocksDB(await t.tmp(), {
+    columnFamilies: [new RocksDB.ColumnFamily('shared', { blockCache: cache })]
+  })
+  await a.ready()
+  await b.ready()
+
+  await a.put('hello', 'world')
+  await a.flush()
+  await b.columnFamily('shared').put('hello', 'world')
+  await b.columnFamily('shared').flush()
+
+  t.alike(await a.get('hello'), Buffer.from('world'))
+  t.alike(await b.columnFamily('shared').get('hello'), Buffer.from('world'))
+
+  t.is(cache.capacity, 8 * 1024 * 1024)
+  t.ok(cache.usage > 0, 'blocks are charged to the shared cache')
+  t.ok(cache.pinnedUsage >= 0)
+
+  await a.close()
+
+  t.exception(() => cache.destroy(), /Block cache is in use/)
+
+  await b.close()
+})
+
+test('hyper clock block cache', async (t) => {
+  const cache = new RocksDB.BlockCache(4 * 1024 * 1024, {
+    type: RocksDB.constants.cacheType.HYPER_CLOCK,
+    shardBits: 2,
+    strictCapacityLimit: true
+  })
+  t.teardown(() => cache.destroy())
+
+  const db = new RocksDB(await t.tmp(), { blockCache: cache })
+  await db.ready()
+
+  await db.put('hello', 'world')
+  t.alike(await db.get('hello'), Buffer.from('world'))
+
+  cache.capacity = 2 * 1024 * 1024
+  t.is(cache.capacity, 2 * 1024 * 1024)
+
+  await db.close()
+})
+
+test('shared write buffer manager', async (t) => {
+  const cache = new RocksDB.BlockCache(8 * 1024 * 1024)
+  const manager = new RocksDB.WriteBufferManager(1024 * 1024, { blockCache: cache })
+  t.teardown(() => {
+    manager.destroy()
+    cache.destroy()
+  })
+
+  const a = new RocksDB(await t.tmp(), { writeBufferManager: manager })
+  const b = new RocksDB(await t.tmp(), { writeBufferManager: manager })
+  await a.ready()
+  await b.ready()
+
+  await a.put('hello', 'world')
+  await b.put('hello', 'world')
+
+  t.is(manager.bufferSize, 1024 * 1024)
+  t.ok(manager.memoryUsage > 0, 'memtables are charged to the manager')
+  t.is(manager.stalled, false)
+
+  manager.bufferSize = 2 * 1024 * 1024
+  t.is(manager.bufferSize, 2 * 1024 * 1024)
+
+  t.alike(await a.get('hello'), Buffer.from('world'))
+  t.alike(await b.get('hello'), Buffer.from('world'))
+
+  await a.close()
+
+  t.exception(() => manager.destroy(), /Write buffer manager is in use/)
+
+  await b.close()
+
+  t.exception(() => cache.destroy(), /Block cache is in use/, 'held by the manager')
+})
+
+test('shared rate limiter', async (t) => {
+  const limiter = new RocksDB.RateLimiter(16 * 1024 * 1024, {
+    mode: RocksDB.constants.rateLimiterMode.ALL_IO
+  })
+  t.teardown(() => limiter.destroy())
+
+  const a = new RocksDB(await t.tmp(), { rateLimiter: limiter })
+  const b = new RocksDB(await t.tmp(), { rateLimiter: limiter })
+  await a.ready()
+  await b.ready()
+
+  await a.put('hello', 'world')
+  await a.flush()
+  await b.put('hello', 'world')
+  await b.flush()
+
+  t.is(limiter.bytesPerSecond, 16 * 1024 * 1024)
+  t.ok(limiter.totalBytesThrough() > 0, 'flushes are accounted')
+  t.ok(limiter.totalBytesThrough(RocksDB.constants.ioPriority.HIGH) > 0)
+
+  limiter.setBytesPerSecond(1024 * 1024)
+  t.is(limiter.bytesPerSecond, 1024 * 1024)
+
+  t.alike(await a.get('hello'), Buffer.from('world'))
+  t.alike(await b.get('hello'), Buffer.from('world'))
+
+  await a.close()
+
+  t.exception(() => limiter.destroy(), /Rate limiter is in use/)
+
+  await b.close()
+})
+
+test('row cache', async (t) => {
+  const db = new RocksDB(await t.tmp(), {
+    rowCache: { capacity: 1024 * 1024 },
+    enableStatistics: true
+  })
+  await db.ready()
+
+  await db.put('hello', 'world')
+  await db.flush()
+
+  t.alike(await db.get('hello'), Buffer.from('world'))
+  t.alike(await db.get('hello'), Buffer.from('world'))
+
+  const { rowCacheHits, rowCacheMisses } = db.refreshStats()
+
+  t.ok(rowCacheMisses > 0, 'first lookup misses')
+  t.ok(rowCacheHits > 0, 'second lookup hits')
+
+  t.alike(await db.get('hello', { rowCache: false }), Buffer.from('world'))
+
+  const stats = db.refreshStats()
+
+  t.is(stats.rowCacheHits, rowCacheHits, 'bypass does not hit')
+  t.is(stats.rowCacheMisses, rowCacheMisses, 'bypass does not miss')
+
+  await db.close()
+})
+
+test('compression per level with dictionary', async (t) => {
+  const { compression } = RocksDB.constants
+
+  const db = new RocksDB(await t.tmp(), {
+    compressionPerLevel: [
+      compression.NONE,
+      compression.NONE,
+      compression.LZ4,
+      compression.LZ4,
+      compression.LZ4,
+      compression.LZ4,
+      compression.ZSTD
+    ],
+    bottommostCompression: compression.ZSTD,
+    compressionLevel: 3,
+    compressionMaxDictBytes: 16 * 1024,
+    compressionZstdMaxTrainBytes: 100 * 16 * 1024
+  })
+  await db.ready()
+
+  let size = 0
+
+  const batch = db.write()
+  for (let i = 0; i < 1000; i++) {
+    const key = 'key' + i
+    const value = JSON.stringify({ id: i, type: 'record', payload: 'x'.repeat(1000) })
+
+    size += key.length + value.length
+    batch.tryPut(key, value)
+  }
+  await batch.flush()
+  batch.destroy()
+
+  await db.compact({
+    bottommostLevelCompaction: RocksDB.constants.bottommostLevelCompaction.FORCE
+  })
+
+  const files = await db.tableProperties()
+  const dataSize = files.reduce((sum, file) => sum + Number(file.dataSize), 0)
+
+  t.ok(dataSize < size / 4, 'bottommost level is compressed')
+
+  const value = JSON.parse(await db.get('key42'))
+
+  t.is(value.id, 42)
+
+  await db.close()
+})
+
+test('blob file compression', async (t) => {
+  const { compression } = RocksDB.constants
+
+  const db = new RocksDB(await t.tmp(), {
+    enableBlobFiles: true,
+    minBlobSize: 64,
+    blobCompression: compression.LZ4
+  })
+  await db.ready()
+
+  let size = 0
+
+  const batch = db.write()
+  for (let i = 0; i < 1000; i++) {
+    const value = JSON.stringify({ id: i, type: 'record', payload: 'x'.repeat(1000) })
+
+    size += value.length
+    batch.tryPut('key' + i, value)
+  }
+  await batch.flush()
+  batch.destroy()
+
+  await db.flush()
+
+  const blobSize = Number(await db.getProperty('rocksdb.total-blob-file-size'))
+
+  t.ok(blobSize > 0, 'values were moved to blob files')
+  t.ok(blobSize < size / 2, 'blob files are compressed')
+
+  t.is(JSON.parse(await db.get('key42')).id, 42)
+
+  await db.close()
+})
+
+test('universal and FIFO compaction styles', async (t) => {
+  const { compactionStyle } = RocksDB.constants
+
+  const dir = await t.tmp()
+
+  const db = new RocksDB(dir, {
+    columnFamilies: [
+      new RocksDB.ColumnFamily('events', {
+        compactionStyle: compactionStyle.UNIVERSAL,
+        universalSizeRatio: 10,
+        universalMaxMergeWidth: 8
+      }),
+      new RocksDB.ColumnFamily('cache', {
+        compactionStyle: compactionStyle.FIFO,
+        numLevels: 1,
+        fifoMaxTableFilesSize: 64 * 1024 * 1024,
+        ttl: 60 * 60
+      })
+    ]
+  })
+  await db.ready()
+
+  for (const name of ['events', 'cache']) {
+    const session = db.columnFamily(name)
+
+    for (let i = 0; i < 4; i++) {
+      await session.put('key' + i, 'value' + i)
+      await session.flush()
+    }
+
+    await session.compact()
+
+    t.alike(await session.get('key3'), Buffer.from('value3'), name)
+  }
+
+  // RocksDB writes the options it actually applied to its OPTIONS file
+  const options = readOptions(dir)
+
+  t.ok(options.default.includes('compaction_style=kCompactionStyleLevel'))
+  // RocksDB resolves its default ttl to 30 days for level compaction
+  t.ok(options.default.includes('ttl=2592000'), 'default ttl')
+
+  t.ok(options.events.includes('compaction_style=kCompactionStyleUniversal'))
+  t.ok(/compaction_options_universal=\{[^}]*\bsize_ratio=10[;}]/.test(options.events))
+  t.ok(/compaction_options_universal=\{[^}]*\bmax_merge_width=8[;}]/.test(options.events))
+
+  t.ok(options.cache.includes('compaction_style=kCompactionStyleFIFO'))
+  t.ok(/compaction_options_fifo=\{[^}]*\bmax_table_files_size=67108864[;}]/.test(options.cache))
+  t.ok(options.cache.includes('ttl=3600'))
+
+  await db.close()
+})
+
+test('FIFO compaction drops the oldest files', async (t) => {
+  const db = new RocksDB(await t.tmp(), {
+    compactionStyle: RocksDB.constants.compactionStyle.FIFO,
+    numLevels: 1,
+    fifoMaxTableFilesSize: 64 * 1024
+  })
+  await db.ready()
+
+  // Six files of about 16 KiB each, so only the newest three or four fit
+  for (let i = 0; i < 6; i++) {
+    const batch = db.write()
+    for (let j = 0; j < 16; j++) batch.tryPut(i + '/' + j, Buffer.alloc(1024, i))
+    await batch.flush()
+    batch.destroy()
+
+    await db.flush()
+  }
+
+  await db.compact()
+
+  const files = await db.tableProperties()
+  const dataSize = files.reduce((sum, file) => sum + Number(file.dataSize), 0)
+
+  t.ok(files.length < 6, 'files were dropped')
+  t.ok(dataSize <= 64 * 1024)
+
+  t.is(await db.get('0/0'), null, 'oldest file dropped')
+  t.alike(await db.get('5/0'), Buffer.alloc(1024, 5), 'newest file kept')
+
+  await db.close()
+})
+
+test('expiry policy', async (t) => {
+  const policy = new RocksDB.ExpiryPolicy()
+
+  const db = new RocksDB(await t.tmp(), { expiryPolicy: policy })
+  await db.ready()
+
+  const now = Math.floor(Date.now() / 1000)
+
+  const batch = db.write()
+  batch.put('expired', policy.encode(Buffer.from('a'), now - 60))
+  batch.put('live', policy.encode(Buffer.from('b'), now + 60 * 60))
+  batch.put('forever', policy.encode(Buffer.from('c'), 0))
+  await batch.flush()
+  batch.destroy()
+
+  t.ok(await db.get('expired'), 'visible until compacted')
+  t.is(await db.get('expired', { skipExpired: true }), null)
+  t.ok(await db.get('live', { skipExpired: true }))
+
+  const keys = []
+  for await (const key of db.keys({}, { skipExpired: true })) keys.push(key.toString())
+
+  t.alike(keys, ['forever', 'live'])
+
+  await db.flush()
+  await db.compact()
+
+  t.is(await db.get('expired'), null, 'dropped by compaction')
+  t.ok(await db.get('live'))
+  t.ok(await db.get('forever'))
+
+  await db.close()
+})
+
+test('drop filter', async (t) => {
+  const filter = new RocksDB.DropFilter({ prefixes: ['a/'] })
+  t.teardown(() => filter.destroy())
+
+  const db = new RocksDB(await t.tmp(), { dropFilter: filter })
+  await db.ready()
+
+  const batch = db.write()
+  for (const prefix of ['a/', 'b/', 'c/']) {
+    for (let i = 0; i < 10; i++) batch.tryPut(prefix + i, 'value')
+  }
+  await batch.flush()
+  batch.destroy()
+
+  await db.flush()
+
+  filter.update({ prefixes: ['a/'], ranges: [{ start: 'b/0', end: 'b/5' }] })
+
+  await db.compact()
+
+  t.is(await db.get('a/1'), null, 'prefix dropped')
+  t.is(await db.get('b/1'), null, 'range dropped')
+  t.alike(await db.get('b/5'), Buffer.from('value'), 'range end is exclusive')
+  t.alike(await db.get('c/1'), Buffer.from('value'))
+
+  t.exception(() => filter.destroy(), /Drop filter is in use/)
+
+  await db.close()
+})
+
+test('compact on deletion + table properties', async (t) => {
+  const db = new RocksDB(await t.tmp(), {
+    compactOnDeletionWindowSize: 128,
+    compactOnDeletionTrigger: 64,
+    compactOnDeletionRatio: 0.5
+  })
+  await db.ready()
+
+  {
+    const batch = db.write()
+    for (let i = 0; i < 256; i++) batch.tryPut('key' + i, 'value')
+    batch.tryPut('live', 'value')
+    await batch.flush()
+    batch.destroy()
+  }
+
+  await db.flush()
+
+  {
+    const batch = db.write()
+    for (let i = 0; i < 256; i++) batch.tryDelete('key' + i)
+    await batch.flush()
+    batch.destroy()
+  }
+
+  await db.flush()
+
+  // Two files are below the level 0 trigger, so only the deletion collector
+  // marking the second one can schedule a compaction. Give it five seconds.
+  for (let i = 0; i < 100; i++) {
+    if ((await db.getProperty('rocksdb.num-files-at-level0')) === '0') break
+    await new Promise((resolve) => setTimeout(resolve, 50))
+  }
+
+  t.is(await db.getProperty('rocksdb.num-files-at-level0'), '0', 'deletions triggered compaction')
+
+  const files = await db.tableProperties()
+
+  t.ok(files.length > 0)
+  t.is(
+    files.reduce((sum, file) => sum + Number(file.deletions), 0),
+    0,
+    'tombstones were compacted away'
+  )
+
+  for (const file of files) {
+    t.is(typeof file.path, 'string')
+    t.ok(Number.isInteger(file.entries))
+    t.ok(Number.isInteger(file.deletions))
+    t.ok(Number.isInteger(file.rangeDeletions))
+  }
+
+  t.alike(await db.get('live'), Buffer.from('value'))
+
+  await db.close()
+})
+
+test('statistics', async (t) => {
+  const db = new RocksDB(await t.tmp(), {
+    enableStatistics: true,
+    statsLevel: RocksDB.constants.statsLevel.ALL
+  })
+  await db.ready()
+
+  await db.put('hello', 'world')
+  await db.get('hello')
+
+  const stats = await db.statistics()
+
+  t.ok(stats.tickers instanceof BigUint64Array)
+  t.is(stats.tickers.length, Object.keys(RocksDB.Statistics.tickers).length)
+  t.ok(stats.ticker('rocksdb.number.keys.written') >= 1)
+  t.ok(stats.ticker('rocksdb.number.keys.read') >= 1)
+
+  const get = stats.histogram('rocksdb.db.get.micros')
+
+  t.ok(get.count >= 1)
+  t.ok(get.max >= get.p50)
+
+  t.is(await db.statistics(stats), stats, 'reuses the result buffers')
+
+  await db.close()
+})
+
+test('statistics without statistics enabled', async (t) => {
+  const db = new RocksDB(await t.tmp())
+  await db.ready()
+
+  await t.exception(db.statistics())
+
+  await db.close()
+})
+
+test('diagnostics with latency histograms', async (t) => {
+  const db = new RocksDB(await t.tmp())
+  await db.ready()
+
+  for (let i = 0; i < 10; i++) await db.put('key' + i, 'value')
+  for (let i = 0; i < 10; i++) await db.get('key' + i)
+  for await (const entry of db.iterator()) t.ok(entry)
+  await db.flush()
+  await db.compact()
+
+  const { latency } = db.diagnostics({ latency: true })
+
+  t.is(latency.write.total.count, 10)
+  t.is(latency.read.total.count, 10)
+  t.ok(latency.iteratorRead.total.count >= 1)
+  t.is(latency.flush.total.count, 1)
+  t.is(latency.compact.total.count, 1)
+
+  for (const phase of ['queue', 'engine', 'total']) {
+    const histogram = latency.read[phase]
+
+    t.ok(histogram.min <= histogram.p50, phase)
+    t.ok(histogram.p50 <= histogram.p99, phase)
+    t.ok(histogram.p99 <= histogram.max, phase)
+  }
+
+  t.absent(db.diagnostics().latency, 'only computed when asked for')
+
+  db.resetLatency()
+
+  t.is(db.diagnostics({ latency: true }).latency.read.total.count, 0)
+
+  await db.close()
+})
+
+test('perf context', async (t) => {
+  const db = new RocksDB(await t.tmp())
+  await db.ready()
+
+  {
+    const batch = db.write({ perf: true })
+    batch.put('hello', 'world')
+    batch.put('hej', 'verden')
+    await batch.flush()
+    t.ok(batch.perf.writeWalTime > 0)
+    t.ok(batch.perf.writeMemtableTime > 0)
+    batch.destroy()
+  }
+
+  await db.flush()
+
+  {
+    const batch = db.read({ perf: true })
+    const p = batch.get('hello')
+    await batch.flush()
+    t.alike(await p, Buffer.from('world'))
+    t.ok(batch.perf.blockReadCount + batch.perf.blockCacheHitCount > 0)
+    t.ok(batch.perf.getFromOutputFilesTime > 0)
+    batch.destroy()
+  }
+
+  {
+    const batch = db.read()
+    batch.get('hello')
+    await batch.flush()
+    t.is(batch.perf, null, 'not captured unless asked for')
+    batch.destroy()
+  }
+
+  {
+    const it = db.iterator({}, { perf: true })
+    for await (const entry of it) t.ok(entry)
+    t.ok(it.perf.seekInternalSeekTime > 0)
+  }
+
+  await t.exception(db.get('hello', { perf: true }), /require a batch/)
+  await t.exception(db.put('hello', 'world', { perf: true }), /require a batch/)
+
+  await db.close()
+})
+
+test('background events', async (t) => {
+  const db = new RocksDB(await t.tmp(), { backgroundEvents: true })
+  await db.ready()
+
+  const flushed = new Promise((resolve) => db.once('flush', resolve))
+
+  await db.put('hello', 'world')
+  await db.flush()
+
+  const event = await flushed
+
+  t.is(event.type, 'flush')
+  t.is(event.columnFamily, 'default')
+  t.ok(event.path.endsWith('.sst'))
+
+  const compacted = new Promise((resolve) => db.once('compaction', resolve))
+
+  await db.put('hej', 'verden')
+  await db.flush()
+  await db.compactRange()
+
+  const compaction = await compacted
+
+  t.ok(compaction.bytesWritten > 0)
+  t.ok(compaction.outputLevel >= compaction.inputLevel)
+
+  await db.close()
+})
+
+test('background events, session listeners', async (t) => {
+  const db = new RocksDB(await t.tmp(), { backgroundEvents: true })
+  await db.ready()
+
+  const session = db.session()
+
+  let sessionFlushes = 0
+  session.on('flush', () => sessionFlushes++)
+
+  let closes = 0
+  db.on('close', () => closes++)
+
+  const flushed = new Promise((resolve) => db.once('flush', resolve))
+
+  await db.put('hello', 'world')
+  await db.flush()
+  await flushed
+
+  t.is(sessionFlushes, 1)
+
+  await session.close()
+
+  t.is(session._listeners, null, 'listeners dropped on close')
+  t.exception(() => session.on('flush', noop), /session is closed/)
+
+  const flushedAgain = new Promise((resolve) => db.once('flush', resolve))
+
+  await db.put('hej', 'verden')
+  await db.flush()
+  await flushedAgain
+
+  t.is(sessionFlushes, 1, 'closed session no longer notified')
+
+  await db.close()
+
+  t.is(closes, 0, 'lifecycle events are not background events')
+})
+
+test('background events disabled', async (t) => {
+  const db = new RocksDB(await t.tmp())
+  await db.ready()
+
+  t.exception(() => db.on('flush', noop), /backgroundEvents/)
+
+  await db.close()
+})
+
+test('write pressure', async (t) => {
+  // Compaction reads its inputs through the limiter while flushes write without
+  // reading, so at this rate the L0 compaction is held back until it's raised
+  const limiter = new RocksDB.RateLimiter(10, {
+    mode: RocksDB.constants.rateLimiterMode.READS_ONLY
+  })
+  t.teardown(() => limiter.destroy())
+
+  const db = new RocksDB(await t.tmp(), {
+    backgroundEvents: true,
+    rateLimiter: limiter,
+    level0FileNumCompactionTrigger: 2,
+    level0SlowdownWritesTrigger: 2,
+    level0StopWritesTrigger: 2
+  })
+  await db.ready()
+
+  const { NORMAL, STOPPED } = RocksDB.constants.writeStallCondition
+
+  t.is(db.writePressure, NORMAL)
+
+  const stopped = pressure(db, STOPPED)
+
+  await db.put('hello', 'world')
+  await db.flush()
+  await db.put('hello', 'verden')
+  await db.flush()
+
+  {
+    // Whether refused by the JS check or by RocksDB, the code is the same
+    const batch = db.write({ failOnPressure: true })
+    const p = batch.put('hej', 'verden')
+    await t.exception(batch.flush(), /Batch was not applied/)
+    await p.then(
+      () => t.fail('write was applied'),
+      (err) => t.is(err.code, 'EAGAIN')
+    )
+    batch.destroy()
+  }
+
+  const event = await stopped
+
+  t.is(event.pressure, STOPPED)
+  t.is(event.previous, NORMAL)
+  t.ok(event.level0Files >= 2)
+  t.is(db.writePressure, STOPPED)
+
+  {
+    const batch = db.write({ failOnPressure: true })
+    const p = batch.put('hej', 'verden')
+    await t.exception(batch.flush(), /Batch was not applied/)
+    await p.then(
+      () => t.fail('write was applied'),
+      (err) => t.is(err.code, 'EAGAIN')
+    )
+    batch.destroy()
+  }
+
+  const normal = pressure(db, NORMAL)
+
+  limiter.setBytesPerSecond(64 * 1024 * 1024)
+
+  await normal
+
+  t.is(db.writePressure, NORMAL)
+
+  {
+    const batch = db.write({ failOnPressure: true })
+    batch.put('hej', 'verden')
+    await batch.flush()
+    batch.destroy()
+  }
+
+  t.alike(await db.get('hej'), Buffer.from('verden'))
+
+  await db.close()
+
+  function pressure(db, condition) {
+    return new Promise((resolve) => {
+      db.on('pressure', function onpressure(event) {
+        if (event.pressure !== condition) return
+        db.off('pressure', onpressure)
+        resolve(event)
+      })
+    })
+  }
+})
+
+test('memory usage', async (t) => {
+  const db = new RocksDB(await t.tmp(), { columnFamilies: ['b'] })
+  await db.ready()
+
+  await db.put('hello', 'world')
+
+  const usage = await db.memoryUsage()
+
+  t.ok(usage.total > 0)
+  t.ok(usage.memtable.total > 0)
+  t.is(usage.total, usage.memtable.total + usage.tableReaders + usage.cache)
+  t.ok(usage.columnFamilies.default.memtable.active > 0)
+  t.is(usage.columnFamilies.default.memtable.immutable, 0)
+  t.ok(usage.columnFamilies.b)
+
+  // A live iterator keeps the memtable it read from after it's flushed
+  const iterator = db.iterator()[Symbol.asyncIterator]()
+  await iterator.next()
+
+  await db.flush()
+
+  const pinned = await db.memoryUsage()
+
+  t.ok(pinned.columnFamilies.default.memtable.pinned > 0)
+  t.ok(pinned.columnFamilies.default.iteratorPinned > 0)
+  t.ok(pinned.iteratorPinned >= pinned.columnFamilies.default.iteratorPinned)
+
+  await iterator.return()
+
+  await db.close()
+})
+
+test('trace + replay', async (t) => {
+  const dir = await t.tmp()
+  const trace = path.join(dir, 'trace')
+  const blockCacheTrace = path.join(dir, 'block-cache-trace')
+
+  const db = new RocksDB(path.join(dir, 'db'))
+  await db.ready()
+
+  await db.startTrace(trace)
+  await db.startBlockCacheTrace(blockCacheTrace)
+
+  await db.put('hello', 'world')
+  await db.flush()
+  await db.get('hello')
+  await db.get('missing')
+
+  await db.endTrace()
+  await db.endBlockCacheTrace()
+
+  await db.close()
+
+  t.ok(fs.statSync(trace).size > 0)
+  t.ok(fs.statSync(blockCacheTrace).size > 0)
+
+  const replay = new RocksDB(path.join(dir, 'replay'))
+  await replay.ready()
+
+  const latency = await replay.replayTrace(trace, { speedup: 10, concurrency: 2 })
+
+  t.is(latency.write.count, 1)
+  t.is(latency.get.count, 2)
+  t.ok(latency.get.max >= latency.get.min)
+
+  t.alike(await replay.get('hello'), Buffer.from('world'))
+
+  await replay.close()
+})
+
+test('executor', async (t) => {
+  const executor = new RocksDB.Executor({ reads: 2, writes: 1, scans: 1, maintenance: 1 })
+
+  const db = new RocksDB(await t.tmp(), { executor })
+  await db.ready()
+
+  const batch = db.write({ capacity: 1000 })
+  for (let i = 0; i < 1000; i++) batch.tryPut('key-' + i, 'value')
+  await batch.flush()
+  batch.destroy()
+
+  const compaction = db.compactRange()
+
+  const reads = []
+  for (let i = 0; i < 100; i++) reads.push(db.get('key-' + i))
+
+  const values = await Promise.all(reads)
+  t.ok(values.every((value) => value.equals(Buffer.from('value'))))
+
+  let entries = 0
+  for await (const entry of db.iterator({ gte: 'key-' })) {
+    if (entry.value.equals(Buffer.from('value'))) entries++
+  }
+  t.is(entries, 1000)
+
+  await compaction
+
+  t.is(executor.pending(RocksDB.constants.executorLane.READ), 0)
+
+  t.exception(() => executor.destroy(), /Executor is in use/)
+
+  await db.close()
+
+  executor.destroy()
+})
+
+test('executor, lanes without workers', async (t) => {
+  t.exception(() => new RocksDB.Executor({ maintenance: 0 }), /no workers/)
+  t.exception(
+    () => new RocksDB.Executor({ reads: 1, writes: 1, scans: 0, maintenance: 0 }),
+    /no workers/
+  )
+
+  const executor = new RocksDB.Executor({ reads: 0, writes: 0, scans: 0, maintenance: 1 })
+
+  const db = new RocksDB(await t.tmp(), { executor })
+  await db.ready()
+
+  await db.put('key', 'value')
+  t.alike(await db.get('key'), Buffer.from('value'))
+
+  let entries = 0
+  for await (const entry of db.iterator()) entries++
+  t.is(entries, 1)
+
+  await db.close()
+
+  executor.destroy()
+})
+
+test('executor, reads are not held behind maintenance', async (t) => {
+  const { MAINTENANCE } = RocksDB.constants.executorLane
+
+  const executor = new RocksDB.Executor({ reads: 1, writes: 1, scans: 1, maintenance: 1 })
+
+  // Compaction reads its inputs through the limiter while point reads don't,
+  // so this keeps the maintenance worker busy until the rate is raised.
+  const limiter = new RocksDB.RateLimiter(10, {
+    mode: RocksDB.constants.rateLimiterMode.READS_ONLY
+  })
+
+  const db = new RocksDB(await t.tmp(), { executor, rateLimiter: limiter })
+  await db.ready()
+
+  for (const value of ['a', 'b']) {
+    const batch = db.write({ capacity: 1000 })
+    for (let i = 0; i < 1000; i++) batch.tryPut('key-' + i, value)
+    await batch.flush()
+    batch.destroy()
+
+    await db.flush()
+  }
+
+  const compactions = [db.compactRange(), db.compactRange()]
+
+  // Wait for the maintenance worker to pick up the first compaction, which
+  // then blocks on the limiter and leaves the second one queued behind it.
+  for (let i = 0; i < 100 && executor.pending(MAINTENANCE) !== 1; i++) {
+    await new Promise((resolve) => setTimeout(resolve, 10))
+  }
+
+  t.is(executor.pending(MAINTENANCE), 1, 'maintenance lane busy')
+
+  const reads = []
+  for (let i = 0; i < 100; i++) reads.push(db.get('key-' + i))
+
+  const values = await Promise.all(reads)
+  t.ok(values.every((value) => value.equals(Buffer.from('b'))))
+  t.is(executor.pending(MAINTENANCE), 1, 'compaction still queued')
+
+  limiter.setBytesPerSecond(1024 * 1024 * 1024)
+
+  await Promise.all(compactions)
+
+  await db.close()
+
+  executor.destroy()
+  limiter.destroy()
+})
+
+test('batched completions', async (t) => {
+  const db = new RocksDB(await t.tmp(), { batchCompletions: true })
+  await db.ready()
+
+  const writes = []
+  for (let i = 0; i < 100; i++) writes.push(db.put('key-' + i, 'value-' + i))
+  await Promise.all(writes)
+
+  const reads = []
+  for (let i = 0; i < 100; i++) reads.push(db.get('key-' + i))
+  reads.push(db.get('missing'))
+
+  const values = await Promise.all(reads)
+
+  t.alike(values.pop(), null)
+  t.ok(values.every((value, i) => value.equals(Buffer.from('value-' + i))))
+
+  {
+    const batch = db.read({ perf: true })
+    const p = batch.get('key-0')
+    await batch.flush()
+    t.alike(await p, Buffer.from('value-0'))
+    t.ok(batch.perf !== null, 'perf requests are delivered directly')
+    batch.destroy()
+  }
+
+  t.is(db._state._inflight.size, 0)
+
+  await db.close()
+})
+
+test('abort signal', async (t) => {
+  const db = new RocksDB(await t.tmp())
+  await db.ready()
+
+  await db.put('hello', 'world')
+
+  {
+    const controller = new AbortController()
+    controller.abort(new Error('aborted'))
+
+    await t.exception(db.get('hello', { signal: controller.signal }), /aborted/)
+  }
+
+  {
+    const controller = new AbortController()
+
+    const p = db.get('hello', { signal: controller.signal, timeout: 1000 })
+    controller.abort(new Error('aborted'))
+
+    await t.exception(p, /aborted/)
+  }
+
+  {
+    const controller = new AbortController()
+
+    const batch = db.read({ signal: controller.signal })
+    const p = batch.get('hello')
+
+    // Abort once the read is submitted but before its completion can arrive.
+    // The completion is delivered on a later tick, so only microtasks may run
+    // in between, and only for as long as the flush takes to submit.
+    const submitted = db._state.stats.readBatches + 1
+    const flushing = batch.flush()
+
+    for (let i = 0; i < 100 && db._state.stats.readBatches < submitted; i++) await null
+
+    t.is(db._state.stats.readBatches, submitted, 'read submitted')
+
+    controller.abort(new Error('aborted'))
+
+    try {
+      await flushing
+      t.fail('read completed before it was aborted')
+    } catch (err) {
+      t.is(err.message, 'aborted')
+    } finally {
+      batch.destroy()
+    }
+
+    await t.exception(p, /aborted/)
+  }
+
+  t.alike(await db.get('hello', { timeout: 1000, ioTimeout: 1000 }), Buffer.from('world'))
+
+  {
+    const controller = new AbortController()
+    controller.abort(new Error('aborted'))
+
+    await t.exception(async () => {
+      for await (const entry of db.iterator({}, { signal: controller.signal })) t.fail(entry)
+    }, /aborted/)
+  }
+
+  {
+    const controller = new AbortController()
+    controller.abort(new Error('aborted'))
+
+    await t.exception(db.compactRange({ signal: controller.signal }), /aborted/)
+  }
+
+  await db.close()
+})
+
+test('abort signal, compaction in progress', async (t) => {
+  // Compaction reads its inputs through the limiter, so this holds it running
+  // until it's canceled.
+  const limiter = new RocksDB.RateLimiter(10, {
+    mode: RocksDB.constants.rateLimiterMode.READS_ONLY
+  })
+
+  const db = new RocksDB(await t.tmp(), { rateLimiter: limiter })
+  await db.ready()
+
+  for (const value of ['a', 'b']) {
+    const batch = db.write({ capacity: 1000 })
+    for (let i = 0; i < 1000; i++) batch.tryPut('key-' + i, value)
+    await batch.flush()
+    batch.destroy()
+
+    await db.flush()
+  }
+
+  const controller = new AbortController()
+
+  const p = db.compactRange({ signal: controller.signal })
+
+  for (let i = 0; i < 100; i++) {
+    if ((await db.getProperty('rocksdb.num-running-compactions')) === '1') break
+    await new Promise((resolve) => setTimeout(resolve, 10))
+  }
+
+  controller.abort(new Error('aborted'))
+
+  try {
+    await p
+    t.fail('compaction finished before it was canceled')
+  } catch (err) {
+    // Only a cancellation reported by RocksDB is replaced by the reason
+    t.is(err.message, 'aborted')
+  }
+
+  t.is(await db.getProperty('rocksdb.num-files-at-level0'), '2', 'compaction skipped')
+
+  limiter.setBytesPerSecond(1024 * 1024 * 1024)
+
+  await db.compactRange()
+
+  t.is(await db.getProperty('rocksdb.num-files-at-level0'), '0')
+
+  await db.close()
+
+  limiter.destroy()
+})
+
+test('read timeout', async (t) => {
+  const db = new RocksDB(await t.tmp())
+  await db.ready()
+
+  const batch = db.write({ capacity: 1000 })
+  for (let i = 0; i < 1000; i++) batch.tryPut('key-' + i, 'value')
+  await batch.flush()
+  batch.destroy()
+
+  await db.flush()
+
+  // A microsecond deadline has passed by the time the worker picks up the read
+  const read = db.read({ capacity: 1000, timeout: 0.001 })
+
+  const reads = []
+  for (let i = 0; i < 1000; i++) reads.push(read.get('key-' + i))
+
+  await read.flush().catch(noop)
+  read.destroy()
+
+  const failed = (await Promise.allSettled(reads)).filter((r) => r.status === 'rejected')
+
+  t.ok(failed.length > 0, 'deadline expired')
+  t.ok(failed.every((r) => r.reason.code === 'ETIMEDOUT'))
+
+  await db.close()
+})
+
+test('has', async (t) => {
+  const db = new RocksDB(await t.tmp())
+  await db.ready()
+
+  const batch = db.write()
+  for (let i = 0; i < 10; i += 2) batch.tryPut('key-' + i, 'value')
+  await batch.flush()
+  batch.destroy()
+
+  await db.flush()
+
+  const keys = []
+  for (let i = 0; i < 10; i++) keys.push('key-' + i)
+
+  const bitmap = await db.has(keys, { confirm: true })
+  t.is(bitmap.byteLength, 2)
+
+  for (let i = 0; i < 10; i++) {
+    t.is((bitmap[i >> 3] >> (i & 7)) & 1, i % 2 === 0 ? 1 : 0, keys[i])
+  }
+
+  const candidates = await db.has(keys)
+  for (let i = 0; i < 10; i += 2) t.is((candidates[i >> 3] >> (i & 7)) & 1, 1)
+
+  t.is(await db.has('key-0'), true)
+  t.is(await db.has('missing', { confirm: true }), false)
+
+  await db.close()
+})
+
+function readOptions(dir) {
+  const name = fs
+    .readdirSync(dir)
+    .filter((name) => name.startsWith('OPTIONS-'))
+    .sort((a, b) => Number(a.slice(8)) - Number(b.slice(8)))
+    .pop()
+
+  const sections = {}
+
+  let section = null
+
+  for (const line of fs.readFileSync(path.join(dir, name), 'utf8').split('\n')) {
+    const match = line.match(/^\[CFOptions "(.+)"\]$/)
+
+    if (match) sections[(section = match[1])] = ''
+    else if (line.startsWith('[')) section = null
+    else if (section !== null) sections[section] += line.trim() + '\n'
+  }
+
+  return sections
+}
+
 function noop() {}